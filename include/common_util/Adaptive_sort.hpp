@@ -0,0 +1,436 @@
+/**
+ * @brief adaptive_sort
+ * @author Jacob Schloss <jacob@schloss.io>
+ * @copyright Copyright (c) 2019 Jacob Schloss. All rights reserved.
+ * @license Licensed under the 3-Clause BSD license. See LICENSE for details
+*/
+
+#pragma once
+
+#include "common_util/Insertion_sort.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+//runs shorter than this are extended with insertion_sort, the real minimum run is picked per input between half and all of it
+constexpr size_t ADAPTIVE_SORT_MIN_MERGE = 64;
+
+//switch to galloping after this many elements in a row came from one side of a merge
+constexpr size_t ADAPTIVE_SORT_MIN_GALLOP = 7;
+
+//size of the merge buffer adaptive_sort(begin, end, comp) puts on the stack
+constexpr size_t ADAPTIVE_SORT_STACK_BYTES = 256;
+
+//enough for any input, run lengths on the stack grow at least as fast as fibonacci numbers
+constexpr size_t ADAPTIVE_SORT_MAX_RUNS = 85;
+
+///
+/// Galloping search from the front of a sorted range, same result as std::lower_bound / std::upper_bound
+/// Takes O(log k) comparisons when the answer is k elements in
+///
+template<class Iter, class T, class Comp>
+Iter adaptive_sort_gallop_lower(Iter first, Iter last, const T& val, Comp comp_lt)
+{
+	const size_t len = last - first;
+
+	size_t prev = 0;
+	size_t ofs  = 1;
+	while((ofs <= len) && comp_lt(first[ofs - 1], val))
+	{
+		prev = ofs;
+		ofs  = 2 * ofs;
+	}
+
+	return std::lower_bound(first + prev, first + std::min(ofs, len), val, comp_lt);
+}
+
+template<class Iter, class T, class Comp>
+Iter adaptive_sort_gallop_upper(Iter first, Iter last, const T& val, Comp comp_lt)
+{
+	const size_t len = last - first;
+
+	size_t prev = 0;
+	size_t ofs  = 1;
+	while((ofs <= len) && !comp_lt(val, first[ofs - 1]))
+	{
+		prev = ofs;
+		ofs  = 2 * ofs;
+	}
+
+	return std::upper_bound(first + prev, first + std::min(ofs, len), val, comp_lt);
+}
+
+///
+/// Galloping search from the back of a sorted range, same result as std::lower_bound / std::upper_bound
+/// Takes O(log k) comparisons when the answer is k elements from the end
+///
+template<class Iter, class T, class Comp>
+Iter adaptive_sort_gallop_lower_back(Iter first, Iter last, const T& val, Comp comp_lt)
+{
+	const size_t len = last - first;
+
+	size_t prev = 0;
+	size_t ofs  = 1;
+	while((ofs <= len) && !comp_lt(*(last - ofs), val))
+	{
+		prev = ofs;
+		ofs  = 2 * ofs;
+	}
+
+	return std::lower_bound(last - std::min(ofs, len), last - prev, val, comp_lt);
+}
+
+template<class Iter, class T, class Comp>
+Iter adaptive_sort_gallop_upper_back(Iter first, Iter last, const T& val, Comp comp_lt)
+{
+	const size_t len = last - first;
+
+	size_t prev = 0;
+	size_t ofs  = 1;
+	while((ofs <= len) && comp_lt(val, *(last - ofs)))
+	{
+		prev = ofs;
+		ofs  = 2 * ofs;
+	}
+
+	return std::upper_bound(last - std::min(ofs, len), last - prev, val, comp_lt);
+}
+
+///
+/// Merge [lo, mid) and [mid, hi) front to back with [lo, mid) moved to buf
+///
+template<class Iter, class Buf, class Comp>
+void adaptive_sort_merge_lo(Iter lo, Iter mid, Iter hi, Buf buf, Comp comp_lt)
+{
+	Buf pa = buf;
+	const Buf pa_end = std::move(lo, mid, buf);
+	Iter pb  = mid;
+	Iter out = lo;
+
+	size_t a_wins = 0;
+	size_t b_wins = 0;
+	while((pa != pa_end) && (pb != hi))
+	{
+		//ties take from a, the left run
+		if(comp_lt(*pb, *pa))
+		{
+			*out = std::move(*pb);
+			++out;
+			++pb;
+			a_wins = 0;
+			b_wins++;
+
+			if(b_wins >= ADAPTIVE_SORT_MIN_GALLOP)
+			{
+				const Iter pb_end = adaptive_sort_gallop_lower(pb, hi, *pa, comp_lt);
+				out = std::move(pb, pb_end, out);
+				pb  = pb_end;
+				b_wins = 0;
+			}
+		}
+		else
+		{
+			*out = std::move(*pa);
+			++out;
+			++pa;
+			b_wins = 0;
+			a_wins++;
+
+			if((a_wins >= ADAPTIVE_SORT_MIN_GALLOP) && (pa != pa_end))
+			{
+				const Buf a_end = adaptive_sort_gallop_upper(pa, pa_end, *pb, comp_lt);
+				out = std::move(pa, a_end, out);
+				pa  = a_end;
+				a_wins = 0;
+			}
+		}
+	}
+
+	//the rest of b is already in place
+	std::move(pa, pa_end, out);
+}
+
+///
+/// Merge [lo, mid) and [mid, hi) back to front with [mid, hi) moved to buf
+///
+template<class Iter, class Buf, class Comp>
+void adaptive_sort_merge_hi(Iter lo, Iter mid, Iter hi, Buf buf, Comp comp_lt)
+{
+	Buf pb = std::move(mid, hi, buf);
+	Iter pa  = mid;
+	Iter out = hi;
+
+	size_t a_wins = 0;
+	size_t b_wins = 0;
+	while((pa != lo) && (pb != buf))
+	{
+		//ties take from b, the right run
+		if(comp_lt(*std::prev(pb), *std::prev(pa)))
+		{
+			--out;
+			--pa;
+			*out = std::move(*pa);
+			b_wins = 0;
+			a_wins++;
+
+			if((a_wins >= ADAPTIVE_SORT_MIN_GALLOP) && (pa != lo))
+			{
+				const Iter a_begin = adaptive_sort_gallop_upper_back(lo, pa, *std::prev(pb), comp_lt);
+				out = std::move_backward(a_begin, pa, out);
+				pa  = a_begin;
+				a_wins = 0;
+			}
+		}
+		else
+		{
+			--out;
+			--pb;
+			*out = std::move(*pb);
+			a_wins = 0;
+			b_wins++;
+
+			if((b_wins >= ADAPTIVE_SORT_MIN_GALLOP) && (pb != buf))
+			{
+				const Buf b_begin = adaptive_sort_gallop_lower_back(buf, pb, *std::prev(pa), comp_lt);
+				out = std::move_backward(b_begin, pb, out);
+				pb  = b_begin;
+				b_wins = 0;
+			}
+		}
+	}
+
+	//the rest of a is already in place
+	std::move_backward(buf, pb, out);
+}
+
+///
+/// Stable merge of [lo, mid) and [mid, hi)
+/// Uses buf when the shorter run fits, otherwise splits with a rotation and merges each half
+///
+template<class Iter, class Buf, class Comp>
+void adaptive_sort_merge(Iter lo, Iter mid, Iter hi, Buf buf, const size_t buf_len, Comp comp_lt)
+{
+	if((lo == mid) || (mid == hi) || !comp_lt(*mid, *std::prev(mid)))
+	{
+		return;
+	}
+
+	//a elements not above b's first and b elements not below a's last are already in place
+	lo = adaptive_sort_gallop_upper(lo, mid, *mid, comp_lt);
+	hi = adaptive_sort_gallop_lower_back(mid, hi, *std::prev(mid), comp_lt);
+
+	const size_t len_a = mid - lo;
+	const size_t len_b = hi - mid;
+
+	if((len_a <= len_b) && (len_a <= buf_len))
+	{
+		adaptive_sort_merge_lo(lo, mid, hi, buf, comp_lt);
+		return;
+	}
+	if(len_b <= buf_len)
+	{
+		adaptive_sort_merge_hi(lo, mid, hi, buf, comp_lt);
+		return;
+	}
+
+	Iter a_cut;
+	Iter b_cut;
+	if(len_a >= len_b)
+	{
+		a_cut = lo + len_a / 2;
+		b_cut = std::lower_bound(mid, hi, *a_cut, comp_lt);
+	}
+	else
+	{
+		b_cut = mid + len_b / 2;
+		a_cut = std::upper_bound(lo, mid, *b_cut, comp_lt);
+	}
+
+	const Iter new_mid = std::rotate(a_cut, mid, b_cut);
+	adaptive_sort_merge(lo, a_cut, new_mid, buf, buf_len, comp_lt);
+	adaptive_sort_merge(new_mid, b_cut, hi, buf, buf_len, comp_lt);
+}
+
+//between ADAPTIVE_SORT_MIN_MERGE / 2 and ADAPTIVE_SORT_MIN_MERGE, so n / min_run is a power of 2 or just under
+inline size_t adaptive_sort_min_run(size_t n)
+{
+	size_t r = 0;
+	while(n >= ADAPTIVE_SORT_MIN_MERGE)
+	{
+		r |= n & 1U;
+		n >>= 1;
+	}
+	return n + r;
+}
+
+///
+/// Length of the run at begin, a strictly descending run is reversed in place
+///
+template<class Iter, class Comp>
+size_t adaptive_sort_count_run(Iter begin, Iter end, Comp comp_lt)
+{
+	Iter i = std::next(begin);
+	if(i == end)
+	{
+		return 1;
+	}
+
+	//strict, so reversing keeps equal elements in order
+	if(comp_lt(*i, *begin))
+	{
+		++i;
+		while((i != end) && comp_lt(*i, *std::prev(i)))
+		{
+			++i;
+		}
+		std::reverse(begin, i);
+	}
+	else
+	{
+		++i;
+		while((i != end) && !comp_lt(*i, *std::prev(i)))
+		{
+			++i;
+		}
+	}
+
+	return i - begin;
+}
+
+///
+/// Stable natural merge sort
+/// Finds ascending and descending runs, extends short ones to a minimum length with insertion_sort, and merges
+/// neighbouring runs with galloping as Timsort does, keeping the pending run lengths roughly fibonacci
+/// O(n) on presorted or reversed input, O(n log n) otherwise
+/// buf holds buf_len constructed elements of scratch space, merges where the shorter run fits in it move that run out once
+/// Longer merges fall back to rotations, which makes them O(n log n) instead of O(n), n / 2 elements is always enough
+/// No allocation, needs random access iterators
+///
+template<class Iter, class Buf, class Comp>
+void adaptive_sort(Iter begin, Iter end, Buf buf, const size_t buf_len, Comp comp_lt)
+{
+	struct Run
+	{
+		size_t base;
+		size_t len;
+	};
+
+	const size_t n = end - begin;
+	if(n < 2)
+	{
+		return;
+	}
+
+	const size_t min_run = adaptive_sort_min_run(n);
+
+	std::array<Run, ADAPTIVE_SORT_MAX_RUNS> runs;
+	size_t num_runs = 0;
+
+	auto merge_at = [&](const size_t i)
+	{
+		const Iter lo  = begin + runs[i].base;
+		const Iter mid = lo + runs[i].len;
+		const Iter hi  = mid + runs[i + 1].len;
+
+		adaptive_sort_merge(lo, mid, hi, buf, buf_len, comp_lt);
+
+		runs[i].len += runs[i + 1].len;
+		for(size_t j = i + 1; j < (num_runs - 1); j++)
+		{
+			runs[j] = runs[j + 1];
+		}
+		num_runs--;
+	};
+
+	size_t pos = 0;
+	while(pos < n)
+	{
+		const Iter run_begin = begin + pos;
+		size_t len = adaptive_sort_count_run(run_begin, end, comp_lt);
+
+		if(len < min_run)
+		{
+			const size_t forced = std::min(min_run, n - pos);
+
+			//the first len elements are in order, so insertion costs nothing until there
+			insertion_sort(run_begin, run_begin + forced, comp_lt, Insertion_sort_binary());
+			len = forced;
+		}
+
+		runs[num_runs].base = pos;
+		runs[num_runs].len  = len;
+		num_runs++;
+		pos += len;
+
+		//keep len[i-2] > len[i-1] + len[i] and len[i-1] > len[i] for the top few runs
+		while(num_runs > 1)
+		{
+			size_t i = num_runs - 2;
+			if(((i > 0) && (runs[i - 1].len <= (runs[i].len + runs[i + 1].len))) || ((i > 1) && (runs[i - 2].len <= (runs[i - 1].len + runs[i].len))))
+			{
+				if(runs[i - 1].len < runs[i + 1].len)
+				{
+					i--;
+				}
+				merge_at(i);
+			}
+			else if(runs[i].len <= runs[i + 1].len)
+			{
+				merge_at(i);
+			}
+			else
+			{
+				break;
+			}
+		}
+	}
+
+	while(num_runs > 1)
+	{
+		size_t i = num_runs - 2;
+		if((i > 0) && (runs[i - 1].len < runs[i + 1].len))
+		{
+			i--;
+		}
+		merge_at(i);
+	}
+}
+
+template<class Iter, class Comp>
+void adaptive_sort_stack_buffer(Iter begin, Iter end, Comp comp_lt, std::true_type)
+{
+	typedef typename std::iterator_traits<Iter>::value_type T;
+
+	std::array<T, ADAPTIVE_SORT_STACK_BYTES / sizeof(T)> buf;
+	adaptive_sort(begin, end, buf.begin(), buf.size(), comp_lt);
+}
+
+template<class Iter, class Comp>
+void adaptive_sort_stack_buffer(Iter begin, Iter end, Comp comp_lt, std::false_type)
+{
+	typedef typename std::iterator_traits<Iter>::value_type T;
+
+	adaptive_sort(begin, end, static_cast<T*>(nullptr), 0, comp_lt);
+}
+
+///
+/// adaptive_sort with an ADAPTIVE_SORT_STACK_BYTES buffer on the stack, or none if the elements are not default constructible
+///
+template<class Iter, class Comp>
+void adaptive_sort(Iter begin, Iter end, Comp comp_lt)
+{
+	typedef typename std::iterator_traits<Iter>::value_type T;
+
+	adaptive_sort_stack_buffer(begin, end, comp_lt, std::integral_constant<bool, std::is_default_constructible<T>::value>());
+}
+
+template<class Iter>
+void adaptive_sort(Iter begin, Iter end)
+{
+	adaptive_sort(begin, end, std::less< typename std::iterator_traits<Iter>::value_type >());
+}
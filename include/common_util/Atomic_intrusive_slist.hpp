@@ -0,0 +1,166 @@
+/**
+ * @brief Lock free intrusive singly linked stack
+ * @author Jacob Schloss <jacob@schloss.io>
+ * @copyright Copyright (c) 2019 Jacob Schloss. All rights reserved.
+ * @license Licensed under the 3-Clause BSD license. See LICENSE for details
+*/
+
+#pragma once
+
+#include "common_util/Intrusive_slist.hpp"
+#include "common_util/Non_copyable.hpp"
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#if !defined(__GNUC__)
+#error "Atomic_intrusive_slist needs the GCC or clang __atomic builtins"
+#endif
+
+//A Treiber stack of Intrusive_slist_node, for free lists shared between threads
+//The head is a tagged pointer in one std::atomic<uint64_t>, the tag is bumped by every update so a pop cannot succeed after the head was popped and pushed back (ABA)
+//On 64 bit targets the pointer takes the low 48 bits and the tag the high 16, on 32 bit targets 32 bits each
+//std::atomic<uint64_t> must be lock free, which rules out cores without a 64 bit exchange like ARMv7-M, this is checked at compile time
+//On 64 bit targets node addresses must fit in the low 48 bits, pack() asserts it
+//A pop reads the next pointer of a head node another thread may have just popped, so nodes must stay valid memory while any thread can pop, as they do in a free list
+//For the same reason this class only touches next pointers with relaxed atomics, and pop leaves the popped node's next as it was
+//A popped node's next must not be written any other way, eg by Intrusive_slist::push_front, while a pop on this stack may still be running
+//That pop would discard the value when its CAS fails, but the plain write and its load are still a data race
+//nodes are held externally, lifetime of nodes must be managed by the creator
+class Atomic_intrusive_slist : private Non_copyable
+{
+public:
+
+	Atomic_intrusive_slist() : m_head(0)
+	{
+
+	}
+
+	~Atomic_intrusive_slist() = default;
+
+	//copy & assign are banned
+	Atomic_intrusive_slist(const Atomic_intrusive_slist& rhs) = delete;
+	Atomic_intrusive_slist& operator=(const Atomic_intrusive_slist& rhs) = delete;
+
+	bool empty() const
+	{
+		return get_ptr(m_head.load(std::memory_order_acquire)) == nullptr;
+	}
+
+	void push(Intrusive_slist_node* const node)
+	{
+		push_chain(node, node);
+	}
+
+	///
+	/// Push the pre-linked chain first .. last with one CAS, first ends up on top
+	///
+	void push_chain(Intrusive_slist_node* const first, Intrusive_slist_node* const last)
+	{
+		uint64_t head = m_head.load(std::memory_order_relaxed);
+		uint64_t next;
+		do
+		{
+			store_next(last, get_ptr(head));
+			next = pack(first, get_tag(head) + 1);
+		} while(!m_head.compare_exchange_weak(head, next, std::memory_order_release, std::memory_order_relaxed));
+	}
+
+	///
+	/// Pop the top node, or nullptr if empty
+	///
+	Intrusive_slist_node* pop()
+	{
+		uint64_t head = m_head.load(std::memory_order_acquire);
+		for(;;)
+		{
+			Intrusive_slist_node* const node = get_ptr(head);
+			if(!node)
+			{
+				return nullptr;
+			}
+
+			//may be stale if node was taken meanwhile, then the tag has moved on and the CAS fails
+			const uint64_t next = pack(load_next(node), get_tag(head) + 1);
+			if(m_head.compare_exchange_weak(head, next, std::memory_order_acquire, std::memory_order_acquire))
+			{
+				return node;
+			}
+		}
+	}
+
+	template<typename T>
+	T* pop()
+	{
+		static_assert(std::is_base_of<Intrusive_slist_node, T>::value);
+
+		return static_cast<T*>(pop());
+	}
+
+	///
+	/// Take every node at once, returns the old top, the rest still linked behind it and nullptr terminated
+	///
+	Intrusive_slist_node* pop_all()
+	{
+		uint64_t head = m_head.load(std::memory_order_relaxed);
+		while(get_ptr(head))
+		{
+			if(m_head.compare_exchange_weak(head, pack(nullptr, get_tag(head) + 1), std::memory_order_acquire, std::memory_order_relaxed))
+			{
+				return get_ptr(head);
+			}
+		}
+
+		return nullptr;
+	}
+
+	template<typename T>
+	T* pop_all()
+	{
+		static_assert(std::is_base_of<Intrusive_slist_node, T>::value);
+
+		return static_cast<T*>(pop_all());
+	}
+
+protected:
+
+	//long long is 64 bits on every target this builds for, is_always_lock_free would need C++17
+	static_assert(ATOMIC_LLONG_LOCK_FREE == 2, "Atomic_intrusive_slist needs a lock free 64 bit atomic");
+
+	static constexpr unsigned PTR_BITS = (sizeof(void*) == 8) ? 48U : 32U;
+	static constexpr uint64_t PTR_MASK = (uint64_t(1) << PTR_BITS) - 1U;
+
+	static uint64_t pack(Intrusive_slist_node* const ptr, const uint64_t tag)
+	{
+		//a pointer with bits above PTR_BITS, eg from LA57 or pointer tagging, would be silently truncated
+		assert(get_ptr(uint64_t(reinterpret_cast<uintptr_t>(ptr)) & PTR_MASK) == ptr);
+
+		return (uint64_t(reinterpret_cast<uintptr_t>(ptr)) & PTR_MASK) | (tag << PTR_BITS);
+	}
+
+	//Intrusive_slist_node::m_next is a plain pointer, std::atomic_ref would need C++20, so this needs the GCC / clang __atomic builtins
+	static Intrusive_slist_node* load_next(const Intrusive_slist_node* const node)
+	{
+		return __atomic_load_n(&node->m_next, __ATOMIC_RELAXED);
+	}
+
+	static void store_next(Intrusive_slist_node* const node, Intrusive_slist_node* const next)
+	{
+		__atomic_store_n(&node->m_next, next, __ATOMIC_RELAXED);
+	}
+
+	static Intrusive_slist_node* get_ptr(const uint64_t val)
+	{
+		return reinterpret_cast<Intrusive_slist_node*>(uintptr_t(val & PTR_MASK));
+	}
+
+	static uint64_t get_tag(const uint64_t val)
+	{
+		return val >> PTR_BITS;
+	}
+
+	std::atomic<uint64_t> m_head;
+};
@@ -0,0 +1,365 @@
+/**
+ * @brief Bit_reader and Bit_writer
+ * @author Jacob Schloss <jacob@schloss.io>
+ * @copyright Copyright (c) 2019 Jacob Schloss. All rights reserved.
+ * @license Licensed under the 3-Clause BSD license. See LICENSE for details
+*/
+
+#pragma once
+
+#include "common_util/Byte_util.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+//Pack and unpack arbitrary width fields to and from a byte buffer
+//MSB_FIRST fills each byte from bit 7 down, as most wire protocols do
+//LSB_FIRST fills each byte from bit 0 up
+enum class Bit_order
+{
+	MSB_FIRST,
+	LSB_FIRST
+};
+
+template<Bit_order ORDER>
+class Bit_reader
+{
+public:
+
+	//widest field a single read can return
+	static constexpr uint8_t MAX_BITS = 32;
+
+	Bit_reader(const uint8_t* const buf, const size_t len)
+	{
+		m_ptr = buf;
+		m_end = buf + len;
+		m_acc = 0;
+		m_count = 0;
+		m_overrun = false;
+	}
+
+	///
+	/// Read a field of nbits, 0 - MAX_BITS
+	/// Reading past the end returns 0 bits and sets overrun
+	///
+	uint32_t read(const uint8_t nbits)
+	{
+		if(nbits == 0)
+		{
+			return 0;
+		}
+
+		if(m_count < nbits)
+		{
+			refill();
+
+			if(m_count < nbits)
+			{
+				//the accumulator is zero past the end of the buffer
+				m_overrun = true;
+				m_count = nbits;
+			}
+		}
+
+		return take(nbits);
+	}
+
+	///
+	/// Read count fields of nbits each, 0 - MAX_BITS
+	/// While 8 bytes remain, refills once per group of 56 / nbits fields and unpacks the group with no per field checks
+	/// The last partial group, the end of the buffer, and fields over 28 bits, which only fit one per refill, go through read
+	///
+	template<typename T>
+	void read_n(T* const out, const size_t count, const uint8_t nbits)
+	{
+		if(nbits == 0)
+		{
+			std::fill_n(out, count, T(0));
+			return;
+		}
+
+		const size_t group = 56U / nbits;
+		const uint8_t group_bits = uint8_t(group * nbits);
+
+		//work on locals so the stores to out do not force the accumulator back to memory
+		const uint8_t* ptr = m_ptr;
+		uint64_t acc = m_acc;
+		uint8_t acc_count = m_count;
+
+		size_t i = 0;
+		while((group > 1) && ((count - i) >= group) && ((m_end - ptr) >= 8))
+		{
+			//same as refill, leaves at least 56 bits
+			if(ORDER == Bit_order::MSB_FIRST)
+			{
+				acc |= Byte_util::load_be<uint64_t>(ptr) >> acc_count;
+			}
+			else
+			{
+				acc |= Byte_util::load_le<uint64_t>(ptr) << acc_count;
+			}
+			ptr += (63U - acc_count) >> 3;
+			acc_count |= 56U;
+
+			T* const group_out = out + i;
+			for(size_t j = 0; j < group; j++)
+			{
+				if(ORDER == Bit_order::MSB_FIRST)
+				{
+					group_out[j] = T(acc >> (64U - nbits));
+					acc <<= nbits;
+				}
+				else
+				{
+					group_out[j] = T(acc & ((uint64_t(1) << nbits) - 1U));
+					acc >>= nbits;
+				}
+			}
+
+			acc_count -= group_bits;
+			i += group;
+		}
+
+		m_ptr = ptr;
+		m_acc = acc;
+		m_count = acc_count;
+
+		for(; i < count; i++)
+		{
+			out[i] = T(read(nbits));
+		}
+	}
+
+	size_t bits_remaining() const
+	{
+		return size_t(m_end - m_ptr) * 8U + m_count;
+	}
+
+	bool overrun() const
+	{
+		return m_overrun;
+	}
+
+protected:
+
+	//m_count >= nbits
+	uint32_t take(const uint8_t nbits)
+	{
+		uint32_t val = 0;
+		if(ORDER == Bit_order::MSB_FIRST)
+		{
+			val = uint32_t(m_acc >> (64U - nbits));
+			m_acc <<= nbits;
+		}
+		else
+		{
+			val = uint32_t(m_acc & ((uint64_t(1) << nbits) - 1U));
+			m_acc >>= nbits;
+		}
+
+		m_count -= nbits;
+
+		return val;
+	}
+
+	//top up the accumulator to at least 56 bits if the buffer has them
+	void refill()
+	{
+		if((m_end - m_ptr) >= 8)
+		{
+			//bits past m_count get loaded again next time at the same position, so or-ing them in early is harmless
+			if(ORDER == Bit_order::MSB_FIRST)
+			{
+				m_acc |= Byte_util::load_be<uint64_t>(m_ptr) >> m_count;
+			}
+			else
+			{
+				m_acc |= Byte_util::load_le<uint64_t>(m_ptr) << m_count;
+			}
+
+			m_ptr += (63U - m_count) >> 3;
+			m_count |= 56U;
+		}
+		else
+		{
+			while((m_count <= 56U) && (m_ptr != m_end))
+			{
+				if(ORDER == Bit_order::MSB_FIRST)
+				{
+					m_acc |= uint64_t(*m_ptr) << (56U - m_count);
+				}
+				else
+				{
+					m_acc |= uint64_t(*m_ptr) << m_count;
+				}
+
+				m_ptr++;
+				m_count += 8U;
+			}
+		}
+	}
+
+	const uint8_t* m_ptr;
+	const uint8_t* m_end;
+
+	//MSB_FIRST keeps bits at the top of m_acc, LSB_FIRST at the bottom
+	uint64_t m_acc;
+	uint8_t m_count;
+
+	bool m_overrun;
+};
+
+template<Bit_order ORDER>
+class Bit_writer
+{
+public:
+
+	//widest field a single write can take
+	static constexpr uint8_t MAX_BITS = 32;
+
+	Bit_writer(uint8_t* const buf, const size_t len)
+	{
+		m_begin = buf;
+		m_ptr = buf;
+		m_end = buf + len;
+		m_acc = 0;
+		m_count = 0;
+		m_overrun = false;
+	}
+
+	///
+	/// Write the low nbits of val, 0 - MAX_BITS
+	/// Bits that do not fit in the buffer are dropped and set overrun
+	///
+	void write(const uint32_t val, const uint8_t nbits)
+	{
+		if(nbits == 0)
+		{
+			return;
+		}
+
+		const uint64_t field = uint64_t(val) & ((uint64_t(1) << nbits) - 1U);
+
+		if(ORDER == Bit_order::MSB_FIRST)
+		{
+			m_acc |= field << (64U - m_count - nbits);
+		}
+		else
+		{
+			m_acc |= field << m_count;
+		}
+
+		m_count += nbits;
+
+		if(m_count >= 32U)
+		{
+			drain_32();
+		}
+	}
+
+	template<typename T>
+	void write_n(const T* const in, const size_t count, const uint8_t nbits)
+	{
+		for(size_t i = 0; i < count; i++)
+		{
+			write(uint32_t(in[i]), nbits);
+		}
+	}
+
+	///
+	/// Write out any buffered bits, padding the last byte with 0
+	/// Returns false if anything was dropped
+	///
+	bool flush()
+	{
+		while(m_count != 0)
+		{
+			put_byte();
+		}
+
+		return !m_overrun;
+	}
+
+	//bytes written to the buffer so far, not counting bits pending a flush
+	size_t bytes_written() const
+	{
+		return m_ptr - m_begin;
+	}
+
+	bool overrun() const
+	{
+		return m_overrun;
+	}
+
+protected:
+
+	void drain_32()
+	{
+		if((m_end - m_ptr) >= 4)
+		{
+			if(ORDER == Bit_order::MSB_FIRST)
+			{
+				Byte_util::store_be<uint32_t>(m_ptr, uint32_t(m_acc >> 32));
+				m_acc <<= 32;
+			}
+			else
+			{
+				Byte_util::store_le<uint32_t>(m_ptr, uint32_t(m_acc));
+				m_acc >>= 32;
+			}
+
+			m_ptr += 4;
+			m_count -= 32U;
+		}
+		else
+		{
+			while(m_count >= 8U)
+			{
+				put_byte();
+			}
+		}
+	}
+
+	//write one byte, or the partial last byte
+	void put_byte()
+	{
+		uint8_t b = 0;
+		if(ORDER == Bit_order::MSB_FIRST)
+		{
+			b = uint8_t(m_acc >> 56);
+			m_acc <<= 8;
+		}
+		else
+		{
+			b = uint8_t(m_acc);
+			m_acc >>= 8;
+		}
+
+		m_count = (m_count > 8U) ? (m_count - 8U) : 0;
+
+		if(m_ptr != m_end)
+		{
+			*m_ptr = b;
+			m_ptr++;
+		}
+		else
+		{
+			m_overrun = true;
+		}
+	}
+
+	uint8_t* m_begin;
+	uint8_t* m_ptr;
+	uint8_t* m_end;
+
+	uint64_t m_acc;
+	uint8_t m_count;
+
+	bool m_overrun;
+};
+
+typedef Bit_reader<Bit_order::MSB_FIRST> Bit_reader_msb;
+typedef Bit_reader<Bit_order::LSB_FIRST> Bit_reader_lsb;
+typedef Bit_writer<Bit_order::MSB_FIRST> Bit_writer_msb;
+typedef Bit_writer<Bit_order::LSB_FIRST> Bit_writer_lsb;
@@ -10,62 +10,92 @@
 #include <array>
 #include <cstdint>
 #include <cstddef>
+#include <type_traits>
 
 class Byte_util
 {
 public:
 
+	///
+	/// Accepts '0'-'9', 'A'-'F' and 'a'-'f'
+	///
 	static constexpr bool hex_to_nibble(const char c, uint8_t* const n)
 	{
-		if( (c >= '0') && (c <= '9') )
-		{
-			*n = c - '0';
-		}
-		else if( (c >= 'A') && (c <= 'F') )
-		{
-			*n = (c - 'A') + 10;
-		}
-		else
+		const uint8_t v = hex_nibble_lut[uint8_t(c)];
+		if(!hex_lut_valid(v))
 		{
 			return false;
 		}
 
+		*n = v;
+
 		return true;
 	}
 
 	static constexpr bool hex_to_byte(const char c[2], uint8_t* const n)
 	{
-		uint8_t n1 = 0;
-		uint8_t n0 = 0;
-		if(!hex_to_nibble(c[0], &n1))
+		const uint8_t n1 = hex_nibble_lut[uint8_t(c[0])];
+		const uint8_t n0 = hex_nibble_lut[uint8_t(c[1])];
+
+		//one check for both nibbles
+		if(!hex_lut_valid(n1 | n0))
 		{
 			return false;
 		}
-		if(!hex_to_nibble(c[1], &n0))
+
+		*n = (n1 << 4) | (n0 << 0);
+
+		return true;
+	}
+
+	static constexpr bool hex_to_u16(const char c[4], uint16_t* const n)
+	{
+		const uint8_t n3 = hex_nibble_lut[uint8_t(c[0])];
+		const uint8_t n2 = hex_nibble_lut[uint8_t(c[1])];
+		const uint8_t n1 = hex_nibble_lut[uint8_t(c[2])];
+		const uint8_t n0 = hex_nibble_lut[uint8_t(c[3])];
+
+		if(!hex_lut_valid(n3 | n2 | n1 | n0))
 		{
 			return false;
 		}
 
-		*n = (n1 << 4) | (n0 << 0);
+		*n = (uint16_t(n3) << 12) | (uint16_t(n2) << 8) | (uint16_t(n1) << 4) | (uint16_t(n0) << 0);
 
 		return true;
 	}
 
-	static constexpr bool hex_to_u16(const char c[4], uint16_t* const n)
+	///
+	/// Parse 8 hex chars as one 64 bit word, validating and converting with SWAR bit tricks
+	///
+	static constexpr bool hex_to_u32(const char c[8], uint32_t* const n)
 	{
-		uint8_t b1 = 0;
-		if(!hex_to_byte(c, &b1))
+		const uint64_t x = hex_swar_load(c);
+
+		if(hex_swar_valid(x) != SWAR_HIGH)
 		{
 			return false;
 		}
 
-		uint8_t b0 = 0;
-		if(!hex_to_byte(c+2, &b0))
+		*n = hex_swar_value(x);
+
+		return true;
+	}
+
+	///
+	/// Parse 16 hex chars as two 64 bit words, with a single validity check
+	///
+	static constexpr bool hex_to_u64(const char c[16], uint64_t* const n)
+	{
+		const uint64_t x1 = hex_swar_load(c);
+		const uint64_t x0 = hex_swar_load(c + 8);
+
+		if((hex_swar_valid(x1) & hex_swar_valid(x0)) != SWAR_HIGH)
 		{
 			return false;
 		}
-		
-		*n = (uint16_t(b1) << 8) | (uint16_t(b0) << 0);
+
+		*n = make_u64(hex_swar_value(x1), hex_swar_value(x0));
 
 		return true;
 	}
@@ -100,7 +130,7 @@ public:
 		u8_to_hex(Byte_util::get_b0(n), c + 6);
 	}
 
-	static void u64_to_hex(const uint32_t n, char c[16])
+	static void u64_to_hex(const uint64_t n, char c[16])
 	{
 		u8_to_hex(Byte_util::get_b7(n), c + 0);
 		u8_to_hex(Byte_util::get_b6(n), c + 2);
@@ -133,30 +163,82 @@ public:
 		out_str->back() = '\0';
 	}
 
+	///
+	/// Encode len bytes from in as 2*len hex chars in out, no null terminator is written
+	/// Uses SSE2/AVX2/NEON when available, with runtime dispatch on x86
+	///
+	static void hex_encode(const uint8_t* const in, const size_t len, char* const out);
+
+	///
+	/// Decode len hex chars from in as len/2 bytes in out
+	/// On failure returns false and sets err_idx to the offset of the first invalid char, if err_idx is not null
+	/// An odd trailing char is reported as invalid
+	/// Bytes before the failing pair are still written to out
+	///
+	static bool hex_decode(const char* const in, const size_t len, uint8_t* const out, size_t* const err_idx = nullptr);
+
+	//byte-at-a-time reference for hex_encode
+	static void hex_encode_scalar(const uint8_t* const in, const size_t len, char* const out)
+	{
+		for(size_t i = 0; i < len; i++)
+		{
+			u8_to_hex(in[i], out + 2*i);
+		}
+	}
+
+	//byte-at-a-time reference for hex_decode
+	static bool hex_decode_scalar(const char* const in, const size_t len, uint8_t* const out, size_t* const err_idx = nullptr)
+	{
+		size_t i = 0;
+		for(; (i+1) < len; i += 2)
+		{
+			if(!hex_to_byte(in + i, out + i/2))
+			{
+				if(err_idx)
+				{
+					uint8_t n = 0;
+					*err_idx = hex_to_nibble(in[i], &n) ? (i+1) : i;
+				}
+				return false;
+			}
+		}
+
+		if(i != len)
+		{
+			if(err_idx)
+			{
+				*err_idx = i;
+			}
+			return false;
+		}
+
+		return true;
+	}
+
 	static bool hex_str_to_u8(const std::array<char, 3>& str, uint8_t* const out_n)
 	{
 		return hex_to_byte(str.data(), out_n);
 	}
 
 	template <typename T>
-	static bool hex_str_to_uT(const std::array<char, sizeof(T)*2+1>& str, T* const out_n)
+	static constexpr bool hex_str_to_uT(const std::array<char, sizeof(T)*2+1>& str, T* const out_n)
 	{
 		T temp = 0;
 
-		char const* str_ptr = str.data();
+		//or together every lut entry and check once at the end
+		uint8_t lut_mask = 0;
 
-		for(size_t i = 0; i < sizeof(T); i++)
+		for(size_t i = 0; i < sizeof(T)*2; i++)
 		{
-			uint8_t b = 0;
-			if(!hex_to_byte(str_ptr, &b))
-			{
-				return false;
-			}
+			const uint8_t v = hex_nibble_lut[uint8_t(str[i])];
+			lut_mask |= v;
 
-			str_ptr += 2;
+			temp = T(temp << 4) | (v & 0x0F);
+		}
 
-			temp <<= 8;
-			temp |= b;
+		if(!hex_lut_valid(lut_mask))
+		{
+			return false;
 		}
 
 		*out_n = temp;
@@ -164,19 +246,19 @@ public:
 		return true;
 	}
 
-	static bool hex_str_to_u16(const std::array<char, 5>& str, uint16_t* const out_n)
+	static constexpr bool hex_str_to_u16(const std::array<char, 5>& str, uint16_t* const out_n)
 	{
 		return hex_str_to_uT<uint16_t>(str, out_n);
 	}
 
-	static bool hex_str_to_u32(const std::array<char, 9>& str, uint32_t* const out_n)
+	static constexpr bool hex_str_to_u32(const std::array<char, 9>& str, uint32_t* const out_n)
 	{
-		return hex_str_to_uT<uint32_t>(str, out_n);
+		return hex_to_u32(&str[0], out_n);
 	}
 
-	static bool hex_str_to_u64(const std::array<char, 17>& str, uint64_t* const out_n)
+	static constexpr bool hex_str_to_u64(const std::array<char, 17>& str, uint64_t* const out_n)
 	{
-		return hex_str_to_uT<uint64_t>(str, out_n);
+		return hex_to_u64(&str[0], out_n);
 	}
 
 	static constexpr char ascii_to_upper(const char c)
@@ -269,6 +351,17 @@ public:
 		return uint32_t(x >> 56) & 0x000000FF;
 	}
 
+	///
+	/// Byte B of x counted from the lsb, same as get_b0 - get_b7 with B picked at compile time
+	///
+	template<size_t B, typename T>
+	static constexpr uint8_t get_b(const T x)
+	{
+		static_assert(std::is_unsigned<T>::value, "get_b needs an unsigned type");
+		static_assert(B < sizeof(T), "get_b byte index out of range");
+		return uint8_t(x >> (8U * B));
+	}
+
 	static constexpr uint8_t bv_8(const uint8_t x)
 	{
 		return 1U << x;
@@ -340,6 +433,77 @@ public:
 		return make_u64(make_u32(b7, b6, b5, b4), make_u32(b3, b2, b1, b0));
 	}
 
+	static constexpr uint16_t bswap_16(const uint16_t x)
+	{
+		return __builtin_bswap16(x);
+	}
+
+	static constexpr uint32_t bswap_32(const uint32_t x)
+	{
+		return __builtin_bswap32(x);
+	}
+
+	static constexpr uint64_t bswap_64(const uint64_t x)
+	{
+		return __builtin_bswap64(x);
+	}
+
+	///
+	/// Byte swap arrays in place, using SIMD shuffles when available
+	///
+	static void bswap_n(uint16_t* const data, const size_t n);
+	static void bswap_n(uint32_t* const data, const size_t n);
+	static void bswap_n(uint64_t* const data, const size_t n);
+
+	///
+	/// Unaligned big endian load of an integer
+	/// Written as shifts so it is constexpr, GCC and clang merge it into one load and a bswap where needed
+	///
+	template<typename T>
+	static constexpr T load_be(const uint8_t* const buf)
+	{
+		static_assert(std::is_integral<T>::value, "T must be an integer");
+		static_assert((sizeof(T) == 1) || (sizeof(T) == 2) || (sizeof(T) == 4) || (sizeof(T) == 8), "T must be 8, 16, 32 or 64 bits");
+
+		return T(load_be_n(buf, std::integral_constant<size_t, sizeof(T)>()));
+	}
+
+	///
+	/// Unaligned little endian load of an integer
+	///
+	template<typename T>
+	static constexpr T load_le(const uint8_t* const buf)
+	{
+		static_assert(std::is_integral<T>::value, "T must be an integer");
+		static_assert((sizeof(T) == 1) || (sizeof(T) == 2) || (sizeof(T) == 4) || (sizeof(T) == 8), "T must be 8, 16, 32 or 64 bits");
+
+		return T(load_le_n(buf, std::integral_constant<size_t, sizeof(T)>()));
+	}
+
+	///
+	/// Unaligned big endian store of an integer
+	///
+	template<typename T>
+	static constexpr void store_be(uint8_t* const buf, const T x)
+	{
+		static_assert(std::is_integral<T>::value, "T must be an integer");
+		static_assert((sizeof(T) == 1) || (sizeof(T) == 2) || (sizeof(T) == 4) || (sizeof(T) == 8), "T must be 8, 16, 32 or 64 bits");
+
+		store_be_n(buf, x, std::integral_constant<size_t, sizeof(T)>());
+	}
+
+	///
+	/// Unaligned little endian store of an integer
+	///
+	template<typename T>
+	static constexpr void store_le(uint8_t* const buf, const T x)
+	{
+		static_assert(std::is_integral<T>::value, "T must be an integer");
+		static_assert((sizeof(T) == 1) || (sizeof(T) == 2) || (sizeof(T) == 4) || (sizeof(T) == 8), "T must be 8, 16, 32 or 64 bits");
+
+		store_le_n(buf, x, std::integral_constant<size_t, sizeof(T)>());
+	}
+
 	static constexpr uint8_t get_upper_half(const uint16_t x)
 	{
 		return uint8_t(x >> 8);
@@ -424,4 +588,188 @@ protected:
 
 	static constexpr char nibble_hex_lut[] = {'0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'A', 'B', 'C', 'D', 'E', 'F'};
 
+	//hex char to nibble value, invalid chars map to HEX_LUT_INVALID
+	static constexpr uint8_t HEX_LUT_INVALID = 0xFF;
+	static constexpr uint8_t hex_nibble_lut[256] = {
+		0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+		0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+		0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+		0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+		0xFF, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+		0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+		0xFF, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+		0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+		0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+		0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+		0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+		0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+		0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+		0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+		0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+		0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF
+	};
+
+	//valid entries are 0-15, so any bit in the upper nibble of a combined entry marks an invalid char
+	static constexpr bool hex_lut_valid(const uint8_t lut_mask)
+	{
+		return (lut_mask & 0xF0) == 0;
+	}
+
+	static constexpr uint64_t SWAR_ONES = 0x0101010101010101ULL;
+	static constexpr uint64_t SWAR_HIGH = 0x8080808080808080ULL;
+
+	//c[0] ends up in the low byte on any host, compilers merge this into a single load
+	static constexpr uint64_t hex_swar_load(const char c[8])
+	{
+		return (uint64_t(uint8_t(c[0])) <<  0) |
+			   (uint64_t(uint8_t(c[1])) <<  8) |
+			   (uint64_t(uint8_t(c[2])) << 16) |
+			   (uint64_t(uint8_t(c[3])) << 24) |
+			   (uint64_t(uint8_t(c[4])) << 32) |
+			   (uint64_t(uint8_t(c[5])) << 40) |
+			   (uint64_t(uint8_t(c[6])) << 48) |
+			   (uint64_t(uint8_t(c[7])) << 56);
+	}
+
+	//high bit of each byte is set if the byte is at least lo, x must be 7 bit clean
+	static constexpr uint64_t swar_ge(const uint64_t x, const uint8_t lo)
+	{
+		return x + SWAR_ONES * (0x80U - lo);
+	}
+
+	//alpha chars have bit 7 set in each byte
+	static constexpr uint64_t hex_swar_alpha(const uint64_t x)
+	{
+		const uint64_t lx = (x & ~SWAR_HIGH) | (SWAR_ONES * 0x20U);
+		return swar_ge(lx, 'a') & ~swar_ge(lx, 'f' + 1) & SWAR_HIGH;
+	}
+
+	//returns SWAR_HIGH if all 8 chars are hex
+	static constexpr uint64_t hex_swar_valid(const uint64_t x)
+	{
+		const uint64_t x7 = x & ~SWAR_HIGH;
+		const uint64_t digit = swar_ge(x7, '0') & ~swar_ge(x7, '9' + 1);
+
+		return (digit | hex_swar_alpha(x)) & ~x & SWAR_HIGH;
+	}
+
+	//convert 8 valid hex chars, c[0] is the most significant nibble
+	static constexpr uint32_t hex_swar_value(const uint64_t x)
+	{
+		//'0'-'9' have the value in the low nibble, 'a'-'f' have 1-6 and need 9 added
+		const uint64_t nib = (x & (SWAR_ONES * 0x0FU)) + ((hex_swar_alpha(x) >> 7) * 9U);
+
+		//merge nibble pairs into bytes, then bytes into a word with c[0..1] in the low byte
+		const uint64_t b = ((nib << 4) | (nib >> 8))  & 0x00FF00FF00FF00FFULL;
+		const uint64_t h = (b | (b >> 8))             & 0x0000FFFF0000FFFFULL;
+		const uint32_t w = uint32_t(h | (h >> 16));
+
+		return __builtin_bswap32(w);
+	}
+
+	//load_be, load_le, store_be and store_le for each width, picked by sizeof(T)
+	static constexpr uint8_t load_be_n(const uint8_t* const buf, std::integral_constant<size_t, 1>)
+	{
+		return buf[0];
+	}
+	static constexpr uint16_t load_be_n(const uint8_t* const buf, std::integral_constant<size_t, 2>)
+	{
+		return make_u16(buf[0], buf[1]);
+	}
+	static constexpr uint32_t load_be_n(const uint8_t* const buf, std::integral_constant<size_t, 4>)
+	{
+		return make_u32(buf[0], buf[1], buf[2], buf[3]);
+	}
+	static constexpr uint64_t load_be_n(const uint8_t* const buf, std::integral_constant<size_t, 8>)
+	{
+		return make_u64(buf[0], buf[1], buf[2], buf[3], buf[4], buf[5], buf[6], buf[7]);
+	}
+
+	static constexpr uint8_t load_le_n(const uint8_t* const buf, std::integral_constant<size_t, 1>)
+	{
+		return buf[0];
+	}
+	static constexpr uint16_t load_le_n(const uint8_t* const buf, std::integral_constant<size_t, 2>)
+	{
+		return make_u16(buf[1], buf[0]);
+	}
+	static constexpr uint32_t load_le_n(const uint8_t* const buf, std::integral_constant<size_t, 4>)
+	{
+		return make_u32(buf[3], buf[2], buf[1], buf[0]);
+	}
+	static constexpr uint64_t load_le_n(const uint8_t* const buf, std::integral_constant<size_t, 8>)
+	{
+		return make_u64(buf[7], buf[6], buf[5], buf[4], buf[3], buf[2], buf[1], buf[0]);
+	}
+
+	template<typename T>
+	static constexpr void store_be_n(uint8_t* const buf, const T x, std::integral_constant<size_t, 1>)
+	{
+		buf[0] = uint8_t(x);
+	}
+	template<typename T>
+	static constexpr void store_be_n(uint8_t* const buf, const T x, std::integral_constant<size_t, 2>)
+	{
+		const uint16_t u = uint16_t(x);
+		buf[0] = get_b1(u);
+		buf[1] = get_b0(u);
+	}
+	template<typename T>
+	static constexpr void store_be_n(uint8_t* const buf, const T x, std::integral_constant<size_t, 4>)
+	{
+		const uint32_t u = uint32_t(x);
+		buf[0] = get_b3(u);
+		buf[1] = get_b2(u);
+		buf[2] = get_b1(u);
+		buf[3] = get_b0(u);
+	}
+	template<typename T>
+	static constexpr void store_be_n(uint8_t* const buf, const T x, std::integral_constant<size_t, 8>)
+	{
+		const uint64_t u = uint64_t(x);
+		buf[0] = get_b7(u);
+		buf[1] = get_b6(u);
+		buf[2] = get_b5(u);
+		buf[3] = get_b4(u);
+		buf[4] = get_b3(u);
+		buf[5] = get_b2(u);
+		buf[6] = get_b1(u);
+		buf[7] = get_b0(u);
+	}
+
+	template<typename T>
+	static constexpr void store_le_n(uint8_t* const buf, const T x, std::integral_constant<size_t, 1>)
+	{
+		buf[0] = uint8_t(x);
+	}
+	template<typename T>
+	static constexpr void store_le_n(uint8_t* const buf, const T x, std::integral_constant<size_t, 2>)
+	{
+		const uint16_t u = uint16_t(x);
+		buf[0] = get_b0(u);
+		buf[1] = get_b1(u);
+	}
+	template<typename T>
+	static constexpr void store_le_n(uint8_t* const buf, const T x, std::integral_constant<size_t, 4>)
+	{
+		const uint32_t u = uint32_t(x);
+		buf[0] = get_b0(u);
+		buf[1] = get_b1(u);
+		buf[2] = get_b2(u);
+		buf[3] = get_b3(u);
+	}
+	template<typename T>
+	static constexpr void store_le_n(uint8_t* const buf, const T x, std::integral_constant<size_t, 8>)
+	{
+		const uint64_t u = uint64_t(x);
+		buf[0] = get_b0(u);
+		buf[1] = get_b1(u);
+		buf[2] = get_b2(u);
+		buf[3] = get_b3(u);
+		buf[4] = get_b4(u);
+		buf[5] = get_b5(u);
+		buf[6] = get_b6(u);
+		buf[7] = get_b7(u);
+	}
+
 };
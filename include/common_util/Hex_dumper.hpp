@@ -0,0 +1,128 @@
+/**
+ * @brief Hex_dumper
+ * @author Jacob Schloss <jacob@schloss.io>
+ * @copyright Copyright (c) 2019 Jacob Schloss. All rights reserved.
+ * @license Licensed under the 3-Clause BSD license. See LICENSE for details
+*/
+
+#pragma once
+
+#include "common_util/Stack_string_base.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+//Streaming xxd style hex dump formatter
+//Input can be fed in arbitrary chunks and output is produced a whole line at a time into caller buffers
+//A line looks like "00000010: 4865 6C6C 6F0A  Hello."
+class Hex_dumper
+{
+public:
+
+	static constexpr size_t MAX_WIDTH = 64;
+	static constexpr size_t MAX_OFFSET_DIGITS = 16;
+	static constexpr size_t MAX_LINE_LEN = (MAX_OFFSET_DIGITS + 2) + (MAX_WIDTH * 3 - 1) + (2 + MAX_WIDTH) + 1;
+
+	Hex_dumper()
+	{
+		m_width = 16;
+		m_group = 2;
+		m_offset_digits = 8;
+		m_show_ascii = true;
+
+		reset(0);
+	}
+
+	//bytes per line, 1 - MAX_WIDTH
+	//fails while a partial line is buffered, flush() first
+	bool set_width(const size_t width)
+	{
+		if((width == 0) || (width > MAX_WIDTH))
+		{
+			return false;
+		}
+
+		if(m_line_fill != 0)
+		{
+			return false;
+		}
+
+		m_width = width;
+		return true;
+	}
+
+	//bytes per space separated group, 0 for no spaces
+	void set_group(const size_t group)
+	{
+		m_group = group;
+	}
+
+	//hex digits in the offset column, 0 to hide it
+	bool set_offset_digits(const size_t digits)
+	{
+		if((digits != 0) && (digits != 8) && (digits != 16))
+		{
+			return false;
+		}
+
+		m_offset_digits = digits;
+		return true;
+	}
+
+	void set_show_ascii(const bool show)
+	{
+		m_show_ascii = show;
+	}
+
+	//drop any pending partial line and restart numbering at base_offset
+	void reset(const uint64_t base_offset)
+	{
+		m_offset = base_offset;
+		m_line_fill = 0;
+	}
+
+	//max chars in one formatted line, including the '\n'
+	size_t line_len() const;
+
+	//offset of the next byte to be fed in
+	uint64_t offset() const
+	{
+		return m_offset + m_line_fill;
+	}
+
+	///
+	/// Consume input and write whole lines to out, up to out_len chars
+	/// Returns the number of input bytes consumed, call again with the rest once there is more output space
+	/// A trailing partial line is held internally until it fills or flush is called
+	///
+	size_t write(const uint8_t* const in, const size_t len, char* const out, const size_t out_len, size_t* const out_written);
+
+	///
+	/// Append whole lines to str, returns the number of input bytes consumed
+	///
+	size_t write(const uint8_t* const in, const size_t len, Stack_string_base* const str);
+
+	///
+	/// Format any pending partial line
+	/// Returns false and keeps the pending line if it does not fit
+	///
+	bool flush(char* const out, const size_t out_len, size_t* const out_written);
+
+	bool flush(Stack_string_base* const str);
+
+protected:
+
+	size_t format_line(const uint8_t* const data, const size_t len, char* const out) const;
+
+	size_t m_width;
+	size_t m_group;
+	size_t m_offset_digits;
+	bool m_show_ascii;
+
+	//offset of m_line[0]
+	uint64_t m_offset;
+
+	std::array<uint8_t, MAX_WIDTH> m_line;
+	size_t m_line_fill;
+};
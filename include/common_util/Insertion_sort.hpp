@@ -1,18 +1,43 @@
 /**
  * @brief insertion_sort
  * @author Jacob Schloss <jacob@schloss.io>
- * @copyright Copyright (c) 2018 Jacob Schloss. All rights reserved.
+ * @copyright Copyright (c) 2018-2019 Jacob Schloss. All rights reserved.
  * @license Licensed under the 3-Clause BSD license. See LICENSE for details
 */
 
 #pragma once
 
+#include "common_util/Network_sort.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
 #include <functional>
 #include <iterator>
+#include <type_traits>
 #include <utility>
 
+///
+/// insertion_sort policies, passed as the last argument
+/// All of them are stable
+///
+
+//swap each element down one step at a time
+struct Insertion_sort_swap {};
+
+//hold the element aside and shift the larger ones up with moves, the default
+struct Insertion_sort_move {};
+
+//binary search for the insertion point, then shift with std::move_backward (memmove for trivially copyable types)
+//fewest comparisons, for expensive comparators
+struct Insertion_sort_binary {};
+
+//like Insertion_sort_move without the bounds check in the inner loop
+//the element before begin must exist and not be greater than any element in the range
+struct Insertion_sort_unguarded {};
+
 template<class Iter, class Comp>
-void insertion_sort(Iter begin, Iter end, Comp comp_lt)
+void insertion_sort(Iter begin, Iter end, Comp comp_lt, Insertion_sort_swap)
 {
 	if(begin == end)
 	{
@@ -30,8 +55,139 @@ void insertion_sort(Iter begin, Iter end, Comp comp_lt)
 	}
 }
 
+template<class Iter, class Comp>
+void insertion_sort(Iter begin, Iter end, Comp comp_lt, Insertion_sort_unguarded)
+{
+	for(Iter i = begin; i != end; ++i)
+	{
+		Iter prev = std::prev(i);
+		if(!comp_lt(*i, *prev))
+		{
+			continue;
+		}
+
+		typename std::iterator_traits<Iter>::value_type val = std::move(*i);
+
+		Iter j = i;
+		do
+		{
+			*j = std::move(*prev);
+			j = prev;
+			--prev;
+		} while(comp_lt(val, *prev));
+
+		*j = std::move(val);
+	}
+}
+
+template<class Iter, class Comp>
+void insertion_sort(Iter begin, Iter end, Comp comp_lt, Insertion_sort_move)
+{
+	if(begin == end)
+	{
+		return;
+	}
+
+	Iter i = begin;
+	++i;
+	for(; i != end; ++i)
+	{
+		if(comp_lt(*i, *begin))
+		{
+			//new minimum, shift the whole prefix
+			typename std::iterator_traits<Iter>::value_type val = std::move(*i);
+			std::move_backward(begin, i, std::next(i));
+			*begin = std::move(val);
+		}
+		else
+		{
+			//*begin is a sentinel for the rest
+			insertion_sort(i, std::next(i), comp_lt, Insertion_sort_unguarded());
+		}
+	}
+}
+
+template<class Iter, class Comp>
+void insertion_sort(Iter begin, Iter end, Comp comp_lt, Insertion_sort_binary)
+{
+	if(begin == end)
+	{
+		return;
+	}
+
+	Iter i = begin;
+	++i;
+	for(; i != end; ++i)
+	{
+		if(!comp_lt(*i, *std::prev(i)))
+		{
+			continue;
+		}
+
+		typename std::iterator_traits<Iter>::value_type val = std::move(*i);
+
+		//after any equal elements, to stay stable
+		const Iter pos = std::upper_bound(begin, i, val, comp_lt);
+		std::move_backward(pos, i, std::next(i));
+		*pos = std::move(val);
+	}
+}
+
+template<class Iter, class Comp>
+void insertion_sort(Iter begin, Iter end, Comp comp_lt)
+{
+	insertion_sort(begin, end, comp_lt, Insertion_sort_move());
+}
+
 template<class Iter>
 void insertion_sort(Iter begin, Iter end)
 {
 	insertion_sort(begin, end, std::less< typename std::iterator_traits<Iter>::value_type >());
 }
+
+///
+/// Fixed size arrays
+/// Arithmetic types up to NETWORK_SORT_MAX_N elements with std::less or std::greater go to network_sort, where stability does not matter
+///
+template<typename T, size_t N, typename Comp>
+struct Insertion_sort_use_network
+{
+	static constexpr bool value = std::is_arithmetic<T>::value && (N <= NETWORK_SORT_MAX_N) && (std::is_same<Comp, std::less<T>>::value || std::is_same<Comp, std::greater<T>>::value);
+};
+
+template<size_t N, class Iter, class Comp>
+void insertion_sort_fixed(Iter begin, Comp comp_lt, std::true_type)
+{
+	network_sort<N>(begin, comp_lt);
+}
+
+template<size_t N, class Iter, class Comp>
+void insertion_sort_fixed(Iter begin, Comp comp_lt, std::false_type)
+{
+	insertion_sort(begin, begin + N, comp_lt);
+}
+
+template<typename T, size_t N, typename Comp>
+void insertion_sort(std::array<T, N>& arr, Comp comp_lt)
+{
+	insertion_sort_fixed<N>(arr.begin(), comp_lt, std::integral_constant<bool, Insertion_sort_use_network<T, N, Comp>::value>());
+}
+
+template<typename T, size_t N>
+void insertion_sort(std::array<T, N>& arr)
+{
+	insertion_sort(arr, std::less<T>());
+}
+
+//Comp must not be T*, which is insertion_sort(arr, arr + N)
+template<typename T, size_t N, typename Comp>
+typename std::enable_if<!std::is_pointer<Comp>::value>::type insertion_sort(T (&arr)[N], Comp comp_lt)
+{
+	insertion_sort_fixed<N>(arr, comp_lt, std::integral_constant<bool, Insertion_sort_use_network<T, N, Comp>::value>());
+}
+
+template<typename T, size_t N>
+void insertion_sort(T (&arr)[N])
+{
+	insertion_sort(arr, std::less<T>());
+}
@@ -0,0 +1,202 @@
+/**
+ * @brief intro_sort and heap_sort
+ * @author Jacob Schloss <jacob@schloss.io>
+ * @copyright Copyright (c) 2019 Jacob Schloss. All rights reserved.
+ * @license Licensed under the 3-Clause BSD license. See LICENSE for details
+*/
+
+#pragma once
+
+#include "common_util/Insertion_sort.hpp"
+
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <utility>
+
+//partitions at or below this size are finished with insertion_sort
+constexpr size_t INTRO_SORT_CUTOFF = 16;
+
+///
+/// Restore the max-heap property below idx, for a heap of len elements at begin
+///
+template<class Iter, class Comp>
+void heap_sift_down(Iter begin, size_t idx, const size_t len, Comp comp_lt)
+{
+	typename std::iterator_traits<Iter>::value_type val = std::move(begin[idx]);
+
+	for(;;)
+	{
+		size_t child = 2 * idx + 1;
+		if(child >= len)
+		{
+			break;
+		}
+
+		if(((child + 1) < len) && comp_lt(begin[child], begin[child + 1]))
+		{
+			child++;
+		}
+
+		if(!comp_lt(val, begin[child]))
+		{
+			break;
+		}
+
+		begin[idx] = std::move(begin[child]);
+		idx = child;
+	}
+
+	begin[idx] = std::move(val);
+}
+
+///
+/// O(n log n) worst case, in place, not stable
+///
+template<class Iter, class Comp>
+void heap_sort(Iter begin, Iter end, Comp comp_lt)
+{
+	const size_t len = end - begin;
+	if(len < 2)
+	{
+		return;
+	}
+
+	for(size_t i = len / 2; i > 0; i--)
+	{
+		heap_sift_down(begin, i - 1, len, comp_lt);
+	}
+
+	for(size_t i = len - 1; i > 0; i--)
+	{
+		std::iter_swap(begin, begin + i);
+		heap_sift_down(begin, 0, i, comp_lt);
+	}
+}
+
+template<class Iter>
+void heap_sort(Iter begin, Iter end)
+{
+	heap_sort(begin, end, std::less< typename std::iterator_traits<Iter>::value_type >());
+}
+
+///
+/// Order *a, *b, *c and leave the median in *out
+///
+template<class Iter, class Comp>
+void intro_sort_median_to(Iter out, Iter a, Iter b, Iter c, Comp comp_lt)
+{
+	if(comp_lt(*b, *a))
+	{
+		std::iter_swap(a, b);
+	}
+	if(comp_lt(*c, *b))
+	{
+		std::iter_swap(b, c);
+		if(comp_lt(*b, *a))
+		{
+			std::iter_swap(a, b);
+		}
+	}
+
+	std::iter_swap(out, b);
+}
+
+///
+/// Hoare partition of (begin, end) around the pivot at *begin
+/// The median of three leaves an element no less than the pivot at end - 1, so the scans need no bounds checks
+///
+template<class Iter, class Comp>
+Iter intro_sort_partition(const Iter begin, const Iter end, Comp comp_lt)
+{
+	Iter first = begin + 1;
+	Iter last = end;
+
+	for(;;)
+	{
+		while(comp_lt(*first, *begin))
+		{
+			++first;
+		}
+
+		--last;
+		while(comp_lt(*begin, *last))
+		{
+			--last;
+		}
+
+		if(!(first < last))
+		{
+			return first;
+		}
+
+		std::iter_swap(first, last);
+		++first;
+	}
+}
+
+//if not leftmost, the element before begin is a lower bound for the range
+template<class Iter, class Comp>
+void intro_sort_loop(Iter begin, Iter end, Comp comp_lt, size_t depth_limit, bool leftmost)
+{
+	while(size_t(end - begin) > INTRO_SORT_CUTOFF)
+	{
+		if(depth_limit == 0)
+		{
+			heap_sort(begin, end, comp_lt);
+			return;
+		}
+		depth_limit--;
+
+		const Iter mid = begin + (end - begin) / 2;
+		intro_sort_median_to(begin, begin + 1, mid, end - 1, comp_lt);
+
+		const Iter cut = intro_sort_partition(begin, end, comp_lt);
+
+		//recurse into the smaller side and loop on the larger, so the stack stays log2(n) deep
+		if((cut - begin) < (end - cut))
+		{
+			intro_sort_loop(begin, cut, comp_lt, depth_limit, leftmost);
+			begin = cut;
+			leftmost = false;
+		}
+		else
+		{
+			intro_sort_loop(cut, end, comp_lt, depth_limit, false);
+			end = cut;
+		}
+	}
+
+	if(leftmost)
+	{
+		insertion_sort(begin, end, comp_lt, Insertion_sort_move());
+	}
+	else
+	{
+		//the pivot left of a right hand partition bounds it
+		insertion_sort(begin, end, comp_lt, Insertion_sort_unguarded());
+	}
+}
+
+///
+/// Median of three quicksort, falling back to heap_sort past 2 log2(n) levels and insertion_sort on small partitions
+/// In place with no allocation, recursion depth is at most log2(n)
+/// Not stable, needs random access iterators
+///
+template<class Iter, class Comp>
+void intro_sort(Iter begin, Iter end, Comp comp_lt)
+{
+	size_t depth_limit = 0;
+	for(size_t n = end - begin; n > 1; n >>= 1)
+	{
+		depth_limit += 2;
+	}
+
+	intro_sort_loop(begin, end, comp_lt, depth_limit, true);
+}
+
+template<class Iter>
+void intro_sort(Iter begin, Iter end)
+{
+	intro_sort(begin, end, std::less< typename std::iterator_traits<Iter>::value_type >());
+}
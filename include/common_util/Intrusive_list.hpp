@@ -7,6 +7,7 @@
 
 #pragma once
 
+#include "common_util/Intrusive_size_policy.hpp"
 #include "common_util/Non_copyable.hpp"
 
 #include <cstddef>
@@ -16,13 +17,15 @@
 //An intrusive doubly linked list for general use
 //Nodes can be allocated wherever, for OS use they are generally on a thread's stack
 
-class Intrusive_list;
+template<typename Size_policy>
+class Intrusive_list_base;
 
 class Intrusive_list_node
 {
 public:
 
-	friend class Intrusive_list;
+	template<typename Size_policy>
+	friend class Intrusive_list_base;
 
 	Intrusive_list_node()
 	{
@@ -104,7 +107,9 @@ protected:
 
 //in this list, nodes are held on the stack externally
 //lifetime of nodes must be managed by the creator
-class Intrusive_list : private Non_copyable
+//Size_policy is Intrusive_walk_size or Intrusive_counted_size, see the typedefs below
+template<typename Size_policy>
+class Intrusive_list_base : private Non_copyable, protected Size_policy
 {
 public:
 
@@ -185,26 +190,27 @@ public:
 	typedef iterator_base<Intrusive_list_node> iterator_type;
 	typedef iterator_base<const Intrusive_list_node> const_iterator_type;
 
-	Intrusive_list()
+	Intrusive_list_base()
 	{
 		m_head = nullptr;
 		m_tail = nullptr;
 	}
 
-	~Intrusive_list() = default;
+	~Intrusive_list_base() = default;
 
 	//copy & assign are banned
 	//Since the nodes are owned externally, it is probably a bad idea to clone the list.
-	Intrusive_list(const Intrusive_list& rhs) = delete;
-	Intrusive_list& operator=(const Intrusive_list& rhs) = delete;
+	Intrusive_list_base(const Intrusive_list_base& rhs) = delete;
+	Intrusive_list_base& operator=(const Intrusive_list_base& rhs) = delete;
 
 	//permit move
-	Intrusive_list(Intrusive_list&& rhs)
+	Intrusive_list_base(Intrusive_list_base&& rhs)
 	{
 		m_head = rhs.m_head;
 		m_tail = rhs.m_tail;
 		rhs.m_head = nullptr;
 		rhs.m_tail = nullptr;
+		this->size_take(rhs);
 	}
 
 	iterator_type begin()
@@ -262,17 +268,10 @@ public:
 		return m_head == nullptr;
 	}
 
+	//O(n) with Intrusive_walk_size, O(1) with Intrusive_counted_size
 	size_t size() const
 	{
-		size_t count = 0;
-		Intrusive_list_node const * n = m_head;
-		while(n)
-		{
-			count++;
-			n = n->m_next;
-		}
-
-		return count;
+		return this->size_of(static_cast<Intrusive_list_node const *>(m_head));
 	}
 
 	void push_front(Intrusive_list_node* const node)
@@ -292,7 +291,9 @@ public:
 
 			m_head = node;
 			m_tail = node;
-		}	
+		}
+
+		this->size_inc();
 	}
 
 	void push_back(Intrusive_list_node* const node)
@@ -312,7 +313,9 @@ public:
 
 			m_head = node;
 			m_tail = node;
-		}	
+		}
+
+		this->size_inc();
 	}
 
 	void pop_front()
@@ -329,6 +332,8 @@ public:
 				m_head = m_head->m_next;
 				m_head->m_prev = nullptr;
 			}
+
+			this->size_dec();
 		}
 	}
 
@@ -346,10 +351,288 @@ public:
 				m_tail = m_tail->m_prev;
 				m_tail->m_next = nullptr;
 			}
+
+			this->size_dec();
+		}
+	}
+
+	///
+	/// Unlink node, which must be in this list, O(1)
+	///
+	void erase(Intrusive_list_node* const node)
+	{
+		if(node->m_prev)
+		{
+			node->m_prev->m_next = node->m_next;
+		}
+		else
+		{
+			m_head = node->m_next;
+		}
+
+		if(node->m_next)
+		{
+			node->m_next->m_prev = node->m_prev;
+		}
+		else
+		{
+			m_tail = node->m_prev;
+		}
+
+		node->m_prev = nullptr;
+		node->m_next = nullptr;
+
+		this->size_dec();
+	}
+
+	///
+	/// Link node in front of pos, which is in this list or nullptr for the end, O(1)
+	///
+	void insert_before(Intrusive_list_node* const pos, Intrusive_list_node* const node)
+	{
+		link_range(pos, node, node);
+
+		this->size_inc();
+	}
+
+	///
+	/// Link node behind pos, which must be in this list, O(1)
+	///
+	void insert_after(Intrusive_list_node* const pos, Intrusive_list_node* const node)
+	{
+		link_range(pos->m_next, node, node);
+
+		this->size_inc();
+	}
+
+	///
+	/// Move all of other in front of pos, which is in this list or nullptr for the end, O(1)
+	///
+	void splice(Intrusive_list_node* const pos, Intrusive_list_base& other)
+	{
+		if((&other == this) || other.empty())
+		{
+			return;
+		}
+
+		Intrusive_list_node* const first = other.m_head;
+		Intrusive_list_node* const back  = other.m_tail;
+		other.m_head = nullptr;
+		other.m_tail = nullptr;
+		this->size_take(other);
+
+		link_range(pos, first, back);
+	}
+
+	///
+	/// Move [first, last) of other in front of pos, last may be nullptr for the end of other
+	/// other may be this list if pos is not in the range
+	/// O(1), except Intrusive_counted_size walks the range to count it
+	///
+	void splice(Intrusive_list_node* const pos, Intrusive_list_base& other, Intrusive_list_node* const first, Intrusive_list_node* const last)
+	{
+		if(first == last)
+		{
+			return;
+		}
+
+		Intrusive_list_node* const back = last ? last->m_prev : other.m_tail;
+		this->size_take_range(other, static_cast<Intrusive_list_node const *>(first), static_cast<Intrusive_list_node const *>(last));
+
+		if(first->m_prev)
+		{
+			first->m_prev->m_next = last;
+		}
+		else
+		{
+			other.m_head = last;
+		}
+
+		if(last)
+		{
+			last->m_prev = first->m_prev;
+		}
+		else
+		{
+			other.m_tail = first->m_prev;
+		}
+
+		link_range(pos, first, back);
+	}
+
+	///
+	/// Stable bottom-up merge sort by relinking nodes, O(n log n) comparisons and O(1) extra space
+	/// comp_lt compares const T&, every node in the list must be a T
+	///
+	template<typename T, typename Comp>
+	void sort(Comp comp_lt)
+	{
+		static_assert(std::is_base_of<Intrusive_list_node, T>::value);
+
+		if(m_head == m_tail)
+		{
+			return;
+		}
+
+		//merge runs of run_len into runs of 2 * run_len until one merge covers the whole list
+		for(size_t run_len = 1; ; run_len *= 2)
+		{
+			Intrusive_list_node* p = m_head;
+			m_head = nullptr;
+			m_tail = nullptr;
+
+			size_t num_merges = 0;
+			while(p)
+			{
+				num_merges++;
+
+				Intrusive_list_node* q = p;
+				size_t p_len = 0;
+				for(size_t i = 0; (i < run_len) && q; i++)
+				{
+					p_len++;
+					q = q->m_next;
+				}
+				size_t q_len = run_len;
+
+				while((p_len > 0) || ((q_len > 0) && q))
+				{
+					Intrusive_list_node* e;
+
+					//ties take from p, the earlier run
+					if((p_len > 0) && ((q_len == 0) || !q || !comp_lt(static_cast<const T&>(*q), static_cast<const T&>(*p))))
+					{
+						e = p;
+						p = p->m_next;
+						p_len--;
+					}
+					else
+					{
+						e = q;
+						q = q->m_next;
+						q_len--;
+					}
+
+					append_node(e);
+				}
+
+				p = q;
+			}
+
+			m_tail->m_next = nullptr;
+
+			if(num_merges <= 1)
+			{
+				return;
+			}
+		}
+	}
+
+	///
+	/// Merge the sorted list other into this sorted list by relinking nodes, other is left empty
+	/// Stable, nodes from this list come before equal nodes from other
+	///
+	template<typename T, typename Comp>
+	void merge(Intrusive_list_base& other, Comp comp_lt)
+	{
+		static_assert(std::is_base_of<Intrusive_list_node, T>::value);
+
+		if(&other == this)
+		{
+			return;
+		}
+
+		Intrusive_list_node* p = m_head;
+		Intrusive_list_node* q = other.m_head;
+		Intrusive_list_node* const p_tail = m_tail;
+		Intrusive_list_node* const q_tail = other.m_tail;
+		m_head = nullptr;
+		m_tail = nullptr;
+		other.m_head = nullptr;
+		other.m_tail = nullptr;
+		this->size_take(other);
+
+		while(p && q)
+		{
+			Intrusive_list_node* e;
+			if(!comp_lt(static_cast<const T&>(*q), static_cast<const T&>(*p)))
+			{
+				e = p;
+				p = p->m_next;
+			}
+			else
+			{
+				e = q;
+				q = q->m_next;
+			}
+
+			append_node(e);
+		}
+
+		//link the rest of whichever list is left in one go
+		if(p)
+		{
+			append_node(p);
+			m_tail = p_tail;
+		}
+		else if(q)
+		{
+			append_node(q);
+			m_tail = q_tail;
 		}
 	}
 
 protected:
+
+	//link the chain first .. back in front of pos, or at the end if pos is nullptr
+	void link_range(Intrusive_list_node* const pos, Intrusive_list_node* const first, Intrusive_list_node* const back)
+	{
+		Intrusive_list_node* const before = pos ? pos->m_prev : m_tail;
+
+		first->m_prev = before;
+		back->m_next  = pos;
+
+		if(before)
+		{
+			before->m_next = first;
+		}
+		else
+		{
+			m_head = first;
+		}
+
+		if(pos)
+		{
+			pos->m_prev = back;
+		}
+		else
+		{
+			m_tail = back;
+		}
+	}
+
+	//link node after m_tail, leaves m_tail->m_next as it was
+	void append_node(Intrusive_list_node* const node)
+	{
+		if(m_tail)
+		{
+			m_tail->m_next = node;
+		}
+		else
+		{
+			m_head = node;
+		}
+
+		node->m_prev = m_tail;
+		m_tail = node;
+	}
+
 	Intrusive_list_node* m_head;
 	Intrusive_list_node* m_tail;
 };
+
+//the original layout, size() walks the list
+typedef Intrusive_list_base<Intrusive_walk_size> Intrusive_list;
+
+//one more word, size() is O(1)
+typedef Intrusive_list_base<Intrusive_counted_size> Intrusive_counted_list;
@@ -0,0 +1,112 @@
+/**
+ * @brief Size policies for Intrusive_list_base and Intrusive_slist_base
+ * @author Jacob Schloss <jacob@schloss.io>
+ * @copyright Copyright (c) 2019 Jacob Schloss. All rights reserved.
+ * @license Licensed under the 3-Clause BSD license. See LICENSE for details
+*/
+
+#pragma once
+
+#include <cstddef>
+
+//size() walks every node, no storage, the default
+class Intrusive_walk_size
+{
+protected:
+	void size_inc()
+	{
+
+	}
+
+	void size_dec()
+	{
+
+	}
+
+	void size_clear()
+	{
+
+	}
+
+	void size_take(Intrusive_walk_size& other)
+	{
+		(void)other;
+	}
+
+	template<typename Node>
+	void size_take_range(Intrusive_walk_size& other, const Node* first, const Node* last)
+	{
+		(void)other;
+		(void)first;
+		(void)last;
+	}
+
+	template<typename Node>
+	size_t size_of(const Node* head) const
+	{
+		size_t count = 0;
+		while(head)
+		{
+			count++;
+			head = head->next();
+		}
+
+		return count;
+	}
+};
+
+//size() is O(1), the count is kept by every operation that links or unlinks nodes
+class Intrusive_counted_size
+{
+protected:
+	Intrusive_counted_size() : m_count(0)
+	{
+
+	}
+
+	void size_inc()
+	{
+		m_count++;
+	}
+
+	void size_dec()
+	{
+		m_count--;
+	}
+
+	void size_clear()
+	{
+		m_count = 0;
+	}
+
+	//add the nodes of other, which is left with none
+	void size_take(Intrusive_counted_size& other)
+	{
+		m_count += other.m_count;
+		other.m_count = 0;
+	}
+
+	//add the nodes [first, last) of other, O(n) in the length of the range
+	template<typename Node>
+	void size_take_range(Intrusive_counted_size& other, const Node* first, const Node* last)
+	{
+		size_t count = 0;
+		while(first != last)
+		{
+			count++;
+			first = first->next();
+		}
+
+		m_count += count;
+		other.m_count -= count;
+	}
+
+	template<typename Node>
+	size_t size_of(const Node* head) const
+	{
+		(void)head;
+		return m_count;
+	}
+
+	size_t m_count;
+};
@@ -7,6 +7,7 @@
 
 #pragma once
 
+#include "common_util/Intrusive_size_policy.hpp"
 #include "common_util/Non_copyable.hpp"
 
 #include <cstddef>
@@ -16,13 +17,25 @@
 //A minimal intrusive singly linked list for OS use
 //Not recommended for general use, since this does not manage memory or have many features
 
-class Intrusive_slist;
+template<typename Size_policy>
+class Intrusive_slist_base;
+
+template<typename Size_policy>
+class Intrusive_slist_queue_base;
+
+class Atomic_intrusive_slist;
 
 class Intrusive_slist_node
 {
 public:
 
-	friend class Intrusive_slist;
+	template<typename Size_policy>
+	friend class Intrusive_slist_base;
+
+	template<typename Size_policy>
+	friend class Intrusive_slist_queue_base;
+
+	friend class Atomic_intrusive_slist;
 
 	Intrusive_slist_node()
 	{
@@ -74,7 +87,9 @@ protected:
 
 //in this list, nodes are held on the stack externally
 //lifetime of nodes must be managed by the creator
-class Intrusive_slist : private Non_copyable
+//Size_policy is Intrusive_walk_size or Intrusive_counted_size, see the typedefs below
+template<typename Size_policy>
+class Intrusive_slist_base : private Non_copyable, protected Size_policy
 {
 public:
 
@@ -141,23 +156,24 @@ template<typename T>
 	typedef iterator_base<Intrusive_slist_node> iterator_type;
 	typedef iterator_base<const Intrusive_slist_node> const_iterator_type;
 
-	Intrusive_slist()
+	Intrusive_slist_base()
 	{
 		m_head = nullptr;
 	}
 
-	~Intrusive_slist() = default;
+	~Intrusive_slist_base() = default;
 
 	//copy & assign are banned
 	//Since the nodes are owned externally, it is probably a bad idea to clone the list.
-	Intrusive_slist(const Intrusive_slist& rhs) = delete;
-	Intrusive_slist& operator=(const Intrusive_slist& rhs) = delete;
+	Intrusive_slist_base(const Intrusive_slist_base& rhs) = delete;
+	Intrusive_slist_base& operator=(const Intrusive_slist_base& rhs) = delete;
 
 	//permit move
-	Intrusive_slist(Intrusive_slist&& rhs)
+	Intrusive_slist_base(Intrusive_slist_base&& rhs)
 	{
 		m_head = rhs.m_head;
 		rhs.m_head = nullptr;
+		this->size_take(rhs);
 	}
 
 	iterator_type begin()
@@ -199,17 +215,10 @@ template<typename T>
 		return m_head == nullptr;
 	}
 
+	//O(n) with Intrusive_walk_size, O(1) with Intrusive_counted_size
 	size_t size() const
 	{
-		size_t count = 0;
-		Intrusive_slist_node const * n = m_head;
-		while(n)
-		{
-			count++;
-			n = n->m_next;
-		}
-
-		return count;
+		return this->size_of(static_cast<Intrusive_slist_node const *>(m_head));
 	}
 
 	void push_front(Intrusive_slist_node* const node)
@@ -224,6 +233,8 @@ template<typename T>
 		}
 		
 		m_head = node;
+
+		this->size_inc();
 	}
 
 	void pop_front()
@@ -231,6 +242,8 @@ template<typename T>
 		if(m_head)
 		{
 			m_head = m_head->m_next;
+
+			this->size_dec();
 		}
 	}
 
@@ -241,38 +254,149 @@ template<typename T>
 			return false;
 		}
 
-		Intrusive_slist_node* prev = nullptr;
-		Intrusive_slist_node* curr = m_head;
-		Intrusive_slist_node* next = curr->m_next;
-
 		if(node == m_head)
 		{
-			curr->m_next = nullptr;	
-			m_head = next;
+			m_head = node->m_next;
+			node->m_next = nullptr;
+
+			this->size_dec();
 			return true;
 		}
 
+		Intrusive_slist_node* prev = m_head;
+		Intrusive_slist_node* curr = m_head->m_next;
 		while(curr)
 		{
 			if(curr == node)
 			{
-				if(prev)
-				{
-					prev->m_next = next;
-				}
-
+				prev->m_next = node->m_next;
 				node->m_next = nullptr;
+
+				this->size_dec();
 				return true;
 			}
 
 			prev = curr;
 			curr = curr->m_next;
-			next = curr->m_next;
 		}
 
 		return false;
 	}
 
+	///
+	/// Stable bottom-up merge sort by relinking nodes, O(n log n) comparisons and O(1) extra space
+	/// comp_lt compares const T&, every node in the list must be a T
+	///
+	template<typename T, typename Comp>
+	void sort(Comp comp_lt)
+	{
+		static_assert(std::is_base_of<Intrusive_slist_node, T>::value);
+
+		if(!m_head || !m_head->m_next)
+		{
+			return;
+		}
+
+		//merge runs of run_len into runs of 2 * run_len until one merge covers the whole list
+		for(size_t run_len = 1; ; run_len *= 2)
+		{
+			Intrusive_slist_node* p = m_head;
+			Intrusive_slist_node** tail = &m_head;
+
+			size_t num_merges = 0;
+			while(p)
+			{
+				num_merges++;
+
+				Intrusive_slist_node* q = p;
+				size_t p_len = 0;
+				for(size_t i = 0; (i < run_len) && q; i++)
+				{
+					p_len++;
+					q = q->m_next;
+				}
+				size_t q_len = run_len;
+
+				while((p_len > 0) || ((q_len > 0) && q))
+				{
+					Intrusive_slist_node* e;
+
+					//ties take from p, the earlier run
+					if((p_len > 0) && ((q_len == 0) || !q || !comp_lt(static_cast<const T&>(*q), static_cast<const T&>(*p))))
+					{
+						e = p;
+						p = p->m_next;
+						p_len--;
+					}
+					else
+					{
+						e = q;
+						q = q->m_next;
+						q_len--;
+					}
+
+					*tail = e;
+					tail = &(e->m_next);
+				}
+
+				p = q;
+			}
+
+			*tail = nullptr;
+
+			if(num_merges <= 1)
+			{
+				return;
+			}
+		}
+	}
+
+	///
+	/// Merge the sorted list other into this sorted list by relinking nodes, other is left empty
+	/// Stable, nodes from this list come before equal nodes from other
+	///
+	template<typename T, typename Comp>
+	void merge(Intrusive_slist_base& other, Comp comp_lt)
+	{
+		static_assert(std::is_base_of<Intrusive_slist_node, T>::value);
+
+		if(&other == this)
+		{
+			return;
+		}
+
+		Intrusive_slist_node* p = m_head;
+		Intrusive_slist_node* q = other.m_head;
+		Intrusive_slist_node** tail = &m_head;
+		other.m_head = nullptr;
+		this->size_take(other);
+
+		while(p && q)
+		{
+			if(!comp_lt(static_cast<const T&>(*q), static_cast<const T&>(*p)))
+			{
+				*tail = p;
+				p = p->m_next;
+			}
+			else
+			{
+				*tail = q;
+				q = q->m_next;
+			}
+
+			tail = &((*tail)->m_next);
+		}
+
+		//link the rest of whichever list is left in one go
+		*tail = p ? p : q;
+	}
+
 protected:
 	Intrusive_slist_node* m_head;
 };
+
+//the original layout, size() walks the list
+typedef Intrusive_slist_base<Intrusive_walk_size> Intrusive_slist;
+
+//one more word, size() is O(1)
+typedef Intrusive_slist_base<Intrusive_counted_size> Intrusive_counted_slist;
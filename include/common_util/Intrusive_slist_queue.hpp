@@ -0,0 +1,220 @@
+/**
+ * @brief Intrusive singly linked FIFO queue
+ * @author Jacob Schloss <jacob@schloss.io>
+ * @copyright Copyright (c) 2019 Jacob Schloss. All rights reserved.
+ * @license Licensed under the 3-Clause BSD license. See LICENSE for details
+*/
+
+#pragma once
+
+#include "common_util/Intrusive_size_policy.hpp"
+#include "common_util/Intrusive_slist.hpp"
+#include "common_util/Non_copyable.hpp"
+
+#include <cstddef>
+#include <type_traits>
+
+//Intrusive_slist with a tail pointer, for FIFO use with one pointer per node instead of the two in Intrusive_list
+//nodes are held externally, lifetime of nodes must be managed by the creator
+//Size_policy is Intrusive_walk_size or Intrusive_counted_size, see the typedefs below
+template<typename Size_policy>
+class Intrusive_slist_queue_base : private Non_copyable, protected Size_policy
+{
+public:
+
+	typedef Intrusive_slist::iterator_type iterator_type;
+	typedef Intrusive_slist::const_iterator_type const_iterator_type;
+
+	Intrusive_slist_queue_base()
+	{
+		m_head = nullptr;
+		m_tail = nullptr;
+	}
+
+	~Intrusive_slist_queue_base() = default;
+
+	//copy & assign are banned
+	//Since the nodes are owned externally, it is probably a bad idea to clone the list.
+	Intrusive_slist_queue_base(const Intrusive_slist_queue_base& rhs) = delete;
+	Intrusive_slist_queue_base& operator=(const Intrusive_slist_queue_base& rhs) = delete;
+
+	//permit move
+	Intrusive_slist_queue_base(Intrusive_slist_queue_base&& rhs)
+	{
+		m_head = rhs.m_head;
+		m_tail = rhs.m_tail;
+		rhs.m_head = nullptr;
+		rhs.m_tail = nullptr;
+		this->size_take(rhs);
+	}
+
+	iterator_type begin()
+	{
+		return iterator_type(m_head);
+	}
+	iterator_type end()
+	{
+		return iterator_type(nullptr);
+	}
+
+	const_iterator_type cbegin() const
+	{
+		return const_iterator_type(m_head);
+	}
+	const_iterator_type cend() const
+	{
+		return const_iterator_type(nullptr);
+	}
+
+	template<typename T>
+	T* front()
+	{
+		static_assert(std::is_base_of<Intrusive_slist_node, T>::value);
+
+		return static_cast<T*>(m_head);
+	}
+
+	template<typename T>
+	const T* front() const
+	{
+		static_assert(std::is_base_of<Intrusive_slist_node, T>::value);
+
+		return static_cast<const T*>(m_head);
+	}
+
+	template<typename T>
+	T* back()
+	{
+		static_assert(std::is_base_of<Intrusive_slist_node, T>::value);
+
+		return static_cast<T*>(m_tail);
+	}
+
+	template<typename T>
+	const T* back() const
+	{
+		static_assert(std::is_base_of<Intrusive_slist_node, T>::value);
+
+		return static_cast<const T*>(m_tail);
+	}
+
+	bool empty() const
+	{
+		return m_head == nullptr;
+	}
+
+	//O(n) with Intrusive_walk_size, O(1) with Intrusive_counted_size
+	size_t size() const
+	{
+		return this->size_of(static_cast<Intrusive_slist_node const *>(m_head));
+	}
+
+	void push_front(Intrusive_slist_node* const node)
+	{
+		node->m_next = m_head;
+		m_head = node;
+
+		if(!m_tail)
+		{
+			m_tail = node;
+		}
+
+		this->size_inc();
+	}
+
+	void push_back(Intrusive_slist_node* const node)
+	{
+		node->m_next = nullptr;
+
+		if(m_tail)
+		{
+			m_tail->m_next = node;
+		}
+		else
+		{
+			m_head = node;
+		}
+
+		m_tail = node;
+
+		this->size_inc();
+	}
+
+	void pop_front()
+	{
+		if(m_head)
+		{
+			Intrusive_slist_node* const node = m_head;
+
+			m_head = node->m_next;
+			if(!m_head)
+			{
+				m_tail = nullptr;
+			}
+
+			node->m_next = nullptr;
+
+			this->size_dec();
+		}
+	}
+
+	///
+	/// Move all of other to the back of this queue, O(1)
+	///
+	void splice_back(Intrusive_slist_queue_base& other)
+	{
+		if((&other == this) || other.empty())
+		{
+			return;
+		}
+
+		if(m_tail)
+		{
+			m_tail->m_next = other.m_head;
+		}
+		else
+		{
+			m_head = other.m_head;
+		}
+
+		m_tail = other.m_tail;
+
+		other.m_head = nullptr;
+		other.m_tail = nullptr;
+		this->size_take(other);
+	}
+
+	///
+	/// Unlink the node after pos, which must be in this queue, O(1)
+	/// Returns the unlinked node, or nullptr if pos was the back
+	///
+	Intrusive_slist_node* erase_after(Intrusive_slist_node* const pos)
+	{
+		Intrusive_slist_node* const node = pos->m_next;
+		if(!node)
+		{
+			return nullptr;
+		}
+
+		pos->m_next = node->m_next;
+		if(node == m_tail)
+		{
+			m_tail = pos;
+		}
+
+		node->m_next = nullptr;
+
+		this->size_dec();
+		return node;
+	}
+
+protected:
+	Intrusive_slist_node* m_head;
+	Intrusive_slist_node* m_tail;
+};
+
+//head and tail pointers only, size() walks the queue
+typedef Intrusive_slist_queue_base<Intrusive_walk_size> Intrusive_slist_queue;
+
+//one more word, size() is O(1)
+typedef Intrusive_slist_queue_base<Intrusive_counted_size> Intrusive_counted_slist_queue;
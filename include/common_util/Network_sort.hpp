@@ -0,0 +1,269 @@
+/**
+ * @brief network_sort
+ * @author Jacob Schloss <jacob@schloss.io>
+ * @copyright Copyright (c) 2019 Jacob Schloss. All rights reserved.
+ * @license Licensed under the 3-Clause BSD license. See LICENSE for details
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+//largest N insertion_sort hands to network_sort for fixed size arrays
+constexpr size_t NETWORK_SORT_MAX_N = 16;
+
+///
+/// One comparator of a sorting network, orders elements A < B
+///
+template<uint8_t A, uint8_t B>
+struct Network_cx
+{
+
+};
+
+template<typename... Cx>
+struct Network_list
+{
+	static constexpr size_t SIZE = sizeof...(Cx);
+};
+
+///
+/// Best known networks, size optimal for N <= 8
+/// type is void where there is no table and network_sort generates Batcher's odd-even merge sort instead
+///
+template<size_t N>
+struct Sort_network
+{
+	typedef void type;
+};
+
+template<>
+struct Sort_network<2>
+{
+	typedef Network_list<
+		Network_cx<0, 1>
+	> type;
+};
+
+template<>
+struct Sort_network<3>
+{
+	typedef Network_list<
+		Network_cx<0, 2>,
+		Network_cx<0, 1>,
+		Network_cx<1, 2>
+	> type;
+};
+
+template<>
+struct Sort_network<4>
+{
+	typedef Network_list<
+		Network_cx<0, 2>, Network_cx<1, 3>,
+		Network_cx<0, 1>, Network_cx<2, 3>,
+		Network_cx<1, 2>
+	> type;
+};
+
+template<>
+struct Sort_network<5>
+{
+	typedef Network_list<
+		Network_cx<0, 3>, Network_cx<1, 4>,
+		Network_cx<0, 2>, Network_cx<1, 3>,
+		Network_cx<0, 1>, Network_cx<2, 4>,
+		Network_cx<1, 2>, Network_cx<3, 4>,
+		Network_cx<2, 3>
+	> type;
+};
+
+template<>
+struct Sort_network<6>
+{
+	typedef Network_list<
+		Network_cx<0, 5>, Network_cx<1, 3>, Network_cx<2, 4>,
+		Network_cx<1, 2>, Network_cx<3, 4>,
+		Network_cx<0, 3>, Network_cx<2, 5>,
+		Network_cx<0, 1>, Network_cx<2, 3>, Network_cx<4, 5>,
+		Network_cx<1, 2>, Network_cx<3, 4>
+	> type;
+};
+
+template<>
+struct Sort_network<7>
+{
+	typedef Network_list<
+		Network_cx<0, 6>, Network_cx<2, 3>, Network_cx<4, 5>,
+		Network_cx<0, 2>, Network_cx<1, 4>, Network_cx<3, 6>,
+		Network_cx<0, 1>, Network_cx<2, 5>, Network_cx<3, 4>,
+		Network_cx<1, 2>, Network_cx<4, 6>,
+		Network_cx<2, 3>, Network_cx<4, 5>,
+		Network_cx<1, 2>, Network_cx<3, 4>, Network_cx<5, 6>
+	> type;
+};
+
+template<>
+struct Sort_network<8>
+{
+	typedef Network_list<
+		Network_cx<0, 2>, Network_cx<1, 3>, Network_cx<4, 6>, Network_cx<5, 7>,
+		Network_cx<0, 4>, Network_cx<1, 5>, Network_cx<2, 6>, Network_cx<3, 7>,
+		Network_cx<0, 1>, Network_cx<2, 3>, Network_cx<4, 5>, Network_cx<6, 7>,
+		Network_cx<2, 4>, Network_cx<3, 5>,
+		Network_cx<1, 4>, Network_cx<3, 6>,
+		Network_cx<1, 2>, Network_cx<3, 4>, Network_cx<5, 6>
+	> type;
+};
+
+//60 comparators in 10 layers
+template<>
+struct Sort_network<16>
+{
+	typedef Network_list<
+		Network_cx<0, 13>, Network_cx<1, 12>, Network_cx<2, 15>, Network_cx<3, 14>, Network_cx<4, 8>, Network_cx<5, 6>, Network_cx<7, 11>, Network_cx<9, 10>,
+		Network_cx<0, 5>, Network_cx<1, 7>, Network_cx<2, 9>, Network_cx<3, 4>, Network_cx<6, 13>, Network_cx<8, 14>, Network_cx<10, 15>, Network_cx<11, 12>,
+		Network_cx<0, 1>, Network_cx<2, 3>, Network_cx<4, 5>, Network_cx<6, 8>, Network_cx<7, 9>, Network_cx<10, 11>, Network_cx<12, 13>, Network_cx<14, 15>,
+		Network_cx<0, 2>, Network_cx<1, 3>, Network_cx<4, 10>, Network_cx<5, 11>, Network_cx<6, 7>, Network_cx<8, 9>, Network_cx<12, 14>, Network_cx<13, 15>,
+		Network_cx<1, 2>, Network_cx<3, 12>, Network_cx<4, 6>, Network_cx<5, 7>, Network_cx<8, 10>, Network_cx<9, 11>, Network_cx<13, 14>,
+		Network_cx<1, 4>, Network_cx<2, 6>, Network_cx<5, 8>, Network_cx<7, 10>, Network_cx<9, 13>, Network_cx<11, 14>,
+		Network_cx<2, 4>, Network_cx<3, 6>, Network_cx<9, 12>, Network_cx<11, 13>,
+		Network_cx<3, 5>, Network_cx<6, 8>, Network_cx<7, 9>, Network_cx<10, 12>,
+		Network_cx<3, 4>, Network_cx<5, 6>, Network_cx<7, 8>, Network_cx<9, 10>, Network_cx<11, 12>,
+		Network_cx<6, 7>, Network_cx<8, 9>
+	> type;
+};
+
+///
+/// Compare-exchange kernels
+///
+
+//arithmetic types with std::less or std::greater, min and max compile to cmov or vector min/max
+struct Network_cx_minmax {};
+struct Network_cx_maxmin {};
+//other trivially copyable types, select both outputs from one comparison
+struct Network_cx_select {};
+//anything else, swap on a branch rather than copy
+struct Network_cx_swap {};
+
+template<typename T, typename Comp>
+struct Network_cx_kernel
+{
+	typedef typename std::conditional<std::is_trivially_copyable<T>::value, Network_cx_select, Network_cx_swap>::type type;
+};
+
+template<typename T>
+struct Network_cx_kernel<T, std::less<T>>
+{
+	typedef typename std::conditional<std::is_arithmetic<T>::value, Network_cx_minmax, typename Network_cx_kernel<T, void>::type>::type type;
+};
+
+template<typename T>
+struct Network_cx_kernel<T, std::greater<T>>
+{
+	typedef typename std::conditional<std::is_arithmetic<T>::value, Network_cx_maxmin, typename Network_cx_kernel<T, void>::type>::type type;
+};
+
+template<typename T, typename Comp>
+inline void network_cmp_exchange(T& a, T& b, Comp, Network_cx_minmax)
+{
+	const T lo = (b < a) ? b : a;
+	const T hi = (b < a) ? a : b;
+	a = lo;
+	b = hi;
+}
+
+template<typename T, typename Comp>
+inline void network_cmp_exchange(T& a, T& b, Comp, Network_cx_maxmin)
+{
+	const T lo = (b > a) ? b : a;
+	const T hi = (b > a) ? a : b;
+	a = lo;
+	b = hi;
+}
+
+template<typename T, typename Comp>
+inline void network_cmp_exchange(T& a, T& b, Comp comp_lt, Network_cx_select)
+{
+	const bool swap = comp_lt(b, a);
+	const T lo = swap ? b : a;
+	const T hi = swap ? a : b;
+	a = lo;
+	b = hi;
+}
+
+template<typename T, typename Comp>
+inline void network_cmp_exchange(T& a, T& b, Comp comp_lt, Network_cx_swap)
+{
+	if(comp_lt(b, a))
+	{
+		using std::swap;
+		swap(a, b);
+	}
+}
+
+template<typename T, typename Comp>
+inline void network_cmp_exchange(T& a, T& b, Comp comp_lt)
+{
+	network_cmp_exchange(a, b, comp_lt, typename Network_cx_kernel<T, Comp>::type());
+}
+
+///
+/// Run a tabled network, fully unrolled
+///
+template<size_t N, class Iter, class Comp, uint8_t... A, uint8_t... B>
+inline void network_sort_apply(Iter begin, Comp comp_lt, Network_list< Network_cx<A, B>... >)
+{
+	//braced init lists evaluate in order
+	const int seq[] = {0, (network_cmp_exchange(begin[A], begin[B], comp_lt), 0)...};
+	(void)seq;
+}
+
+///
+/// Batcher's odd-even merge sort for any N, loop bounds are compile time constants so the compiler can unroll it
+///
+template<size_t N, class Iter, class Comp>
+inline void network_sort_apply(Iter begin, Comp comp_lt, void*)
+{
+	for(size_t p = 1; p < N; p <<= 1)
+	{
+		for(size_t k = p; k >= 1; k >>= 1)
+		{
+			for(size_t j = k % p; (j + k) < N; j += 2 * k)
+			{
+				const size_t i_end = ((N - j - k) < k) ? (N - j - k) : k;
+				for(size_t i = 0; i < i_end; i++)
+				{
+					if(((i + j) / (2 * p)) == ((i + j + k) / (2 * p)))
+					{
+						network_cmp_exchange(begin[i + j], begin[i + j + k], comp_lt);
+					}
+				}
+			}
+		}
+	}
+}
+
+///
+/// Sort the N elements at begin with a fixed compare-exchange network
+/// Data independent control flow, branch free for arithmetic and trivially copyable types
+/// Not stable, needs random access iterators
+///
+template<size_t N, class Iter, class Comp>
+inline void network_sort(Iter begin, Comp comp_lt)
+{
+	typedef typename Sort_network<N>::type Network;
+	typedef typename std::conditional<std::is_void<Network>::value, void*, Network>::type Tag;
+
+	network_sort_apply<N>(begin, comp_lt, Tag());
+}
+
+template<size_t N, class Iter>
+inline void network_sort(Iter begin)
+{
+	network_sort<N>(begin, std::less< typename std::iterator_traits<Iter>::value_type >());
+}
@@ -0,0 +1,264 @@
+/**
+ * @brief parallel_sort
+ * @author Jacob Schloss <jacob@schloss.io>
+ * @copyright Copyright (c) 2019 Jacob Schloss. All rights reserved.
+ * @license Licensed under the 3-Clause BSD license. See LICENSE for details
+*/
+
+#pragma once
+
+#include "common_util/Intro_sort.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <iterator>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+//each thread gets at least this many elements, smaller ranges are sorted on the calling thread
+constexpr size_t PARALLEL_SORT_MIN_CHUNK = 16384;
+
+///
+/// Run fn(0) .. fn(num_threads - 1) concurrently, fn(0) on the calling thread
+/// If a thread cannot be started, that part and the rest run on the calling thread after fn(0)
+/// Every started thread is joined before returning, the first exception thrown by any fn is then rethrown
+///
+template<class Fn>
+void parallel_sort_run(const size_t num_threads, Fn fn)
+{
+	std::vector<std::exception_ptr> errors(num_threads);
+	auto run_one = [&fn, &errors](const size_t i)
+	{
+		try
+		{
+			fn(i);
+		}
+		catch(...)
+		{
+			errors[i] = std::current_exception();
+		}
+	};
+
+	std::vector<std::thread> threads;
+	threads.reserve(num_threads - 1);
+
+	size_t num_started = 1;
+	for(; num_started < num_threads; num_started++)
+	{
+		try
+		{
+			threads.emplace_back(run_one, num_started);
+		}
+		catch(const std::system_error&)
+		{
+			break;
+		}
+	}
+
+	run_one(0);
+	for(size_t i = num_started; i < num_threads; i++)
+	{
+		run_one(i);
+	}
+
+	for(std::thread& t : threads)
+	{
+		t.join();
+	}
+
+	for(const std::exception_ptr& e : errors)
+	{
+		if(e)
+		{
+			std::rethrow_exception(e);
+		}
+	}
+}
+
+///
+/// Move merge of k sorted runs to out, runs is modified
+///
+template<class In, class Out, class Comp>
+void parallel_sort_kway_merge(std::pair<In, In>* const runs, size_t k, Out out, Comp comp_lt)
+{
+	//drop empty runs
+	size_t num_runs = 0;
+	for(size_t i = 0; i < k; i++)
+	{
+		if(runs[i].first != runs[i].second)
+		{
+			runs[num_runs] = runs[i];
+			num_runs++;
+		}
+	}
+	k = num_runs;
+
+	if(k == 0)
+	{
+		return;
+	}
+	if(k == 1)
+	{
+		std::move(runs[0].first, runs[0].second, out);
+		return;
+	}
+	if(k == 2)
+	{
+		std::merge(
+			std::make_move_iterator(runs[0].first), std::make_move_iterator(runs[0].second),
+			std::make_move_iterator(runs[1].first), std::make_move_iterator(runs[1].second),
+			out,
+			comp_lt
+		);
+		return;
+	}
+
+	//min heap of run indices by head element
+	std::vector<size_t> heap(k);
+	for(size_t i = 0; i < k; i++)
+	{
+		heap[i] = i;
+	}
+
+	auto heap_comp = [runs, &comp_lt](const size_t lhs, const size_t rhs)
+	{
+		return comp_lt(*runs[rhs].first, *runs[lhs].first);
+	};
+	std::make_heap(heap.begin(), heap.end(), heap_comp);
+
+	while(!heap.empty())
+	{
+		std::pop_heap(heap.begin(), heap.end(), heap_comp);
+		const size_t r = heap.back();
+
+		*out = std::move(*runs[r].first);
+		++out;
+		++runs[r].first;
+
+		if(runs[r].first == runs[r].second)
+		{
+			heap.pop_back();
+		}
+		else
+		{
+			std::push_heap(heap.begin(), heap.end(), heap_comp);
+		}
+	}
+}
+
+///
+/// Sort with up to num_threads std::threads, 0 uses std::thread::hardware_concurrency()
+/// The range is moved to a temporary buffer and split into one chunk per thread, each sorted with intro_sort
+/// Splitters are picked from a regular sample of the sorted chunks (PSRS), then each thread k-way merges
+/// the pieces of every chunk between two splitters back into its own part of the range
+/// Ranges under 2 * PARALLEL_SORT_MIN_CHUNK, or a single thread, are sorted with intro_sort on the calling thread
+/// Allocates, not stable, needs random access iterators and move constructible elements
+/// If comp_lt or a move throws, the exception reaches the caller once every thread has finished, the range is then left unspecified
+///
+template<class Iter, class Comp>
+void parallel_sort(Iter begin, Iter end, Comp comp_lt, size_t num_threads)
+{
+	typedef typename std::iterator_traits<Iter>::value_type T;
+	typedef typename std::vector<T>::iterator Buf_iter;
+
+	const size_t n = end - begin;
+
+	if(num_threads == 0)
+	{
+		num_threads = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+	}
+	num_threads = std::min(num_threads, n / PARALLEL_SORT_MIN_CHUNK);
+
+	if(num_threads < 2)
+	{
+		intro_sort(begin, end, comp_lt);
+		return;
+	}
+
+	std::vector<T> buf(std::make_move_iterator(begin), std::make_move_iterator(end));
+
+	//chunk i is [chunk_begin[i], chunk_begin[i+1])
+	std::vector<size_t> chunk_begin(num_threads + 1);
+	for(size_t i = 0; i <= num_threads; i++)
+	{
+		chunk_begin[i] = (n * i) / num_threads;
+	}
+
+	parallel_sort_run(num_threads, [&](const size_t i)
+	{
+		intro_sort(buf.begin() + chunk_begin[i], buf.begin() + chunk_begin[i + 1], comp_lt);
+	});
+
+	//num_threads evenly spaced samples per chunk, sorted
+	std::vector<Buf_iter> samples;
+	samples.reserve(num_threads * num_threads);
+	for(size_t i = 0; i < num_threads; i++)
+	{
+		const size_t len = chunk_begin[i + 1] - chunk_begin[i];
+		for(size_t j = 0; j < num_threads; j++)
+		{
+			samples.push_back(buf.begin() + chunk_begin[i] + (len * j) / num_threads);
+		}
+	}
+	std::sort(samples.begin(), samples.end(), [&comp_lt](const Buf_iter& lhs, const Buf_iter& rhs)
+	{
+		return comp_lt(*lhs, *rhs);
+	});
+
+	//cuts[i * (num_threads + 1) + j] is where part j starts in chunk i
+	const size_t stride = num_threads + 1;
+	std::vector<Buf_iter> cuts(num_threads * stride);
+	for(size_t i = 0; i < num_threads; i++)
+	{
+		const Buf_iter c_begin = buf.begin() + chunk_begin[i];
+		const Buf_iter c_end   = buf.begin() + chunk_begin[i + 1];
+
+		cuts[i * stride] = c_begin;
+		for(size_t j = 1; j < num_threads; j++)
+		{
+			const Buf_iter& splitter = samples[j * num_threads + num_threads / 2];
+			cuts[i * stride + j] = std::lower_bound(cuts[i * stride + j - 1], c_end, *splitter, comp_lt);
+		}
+		cuts[i * stride + num_threads] = c_end;
+	}
+
+	//part j goes to out_begin[j]
+	std::vector<size_t> out_begin(num_threads + 1);
+	out_begin[0] = 0;
+	for(size_t j = 0; j < num_threads; j++)
+	{
+		size_t len = 0;
+		for(size_t i = 0; i < num_threads; i++)
+		{
+			len += cuts[i * stride + j + 1] - cuts[i * stride + j];
+		}
+		out_begin[j + 1] = out_begin[j] + len;
+	}
+
+	parallel_sort_run(num_threads, [&](const size_t j)
+	{
+		std::vector< std::pair<Buf_iter, Buf_iter> > runs(num_threads);
+		for(size_t i = 0; i < num_threads; i++)
+		{
+			runs[i] = std::make_pair(cuts[i * stride + j], cuts[i * stride + j + 1]);
+		}
+
+		parallel_sort_kway_merge(runs.data(), runs.size(), begin + out_begin[j], comp_lt);
+	});
+}
+
+template<class Iter, class Comp>
+void parallel_sort(Iter begin, Iter end, Comp comp_lt)
+{
+	parallel_sort(begin, end, comp_lt, 0);
+}
+
+template<class Iter>
+void parallel_sort(Iter begin, Iter end)
+{
+	parallel_sort(begin, end, std::less< typename std::iterator_traits<Iter>::value_type >(), 0);
+}
@@ -0,0 +1,306 @@
+/**
+ * @brief partial_insertion_sort, partial_heap_sort, intro_select and Top_k
+ * @author Jacob Schloss <jacob@schloss.io>
+ * @copyright Copyright (c) 2019 Jacob Schloss. All rights reserved.
+ * @license Licensed under the 3-Clause BSD license. See LICENSE for details
+*/
+
+#pragma once
+
+#include "common_util/Insertion_sort.hpp"
+#include "common_util/Intro_sort.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <utility>
+
+///
+/// Leave the mid - begin smallest elements sorted in [begin, mid), the rest in [mid, end) in no particular order
+/// Each element of [mid, end) costs one comparison unless it belongs in the prefix, then an insertion
+/// O(n) for small k on random input, O(n k) worst case, for k up to a few dozen
+///
+template<class Iter, class Comp>
+void partial_insertion_sort(Iter begin, Iter mid, Iter end, Comp comp_lt)
+{
+	if(begin == mid)
+	{
+		return;
+	}
+
+	insertion_sort(begin, mid, comp_lt);
+
+	const Iter last = std::prev(mid);
+	for(Iter i = mid; i != end; ++i)
+	{
+		if(!comp_lt(*i, *last))
+		{
+			continue;
+		}
+
+		//drop the largest of the prefix out to i and insert *i in its place
+		typename std::iterator_traits<Iter>::value_type val = std::move(*i);
+		*i = std::move(*last);
+
+		Iter j = last;
+		while((j != begin) && comp_lt(val, *std::prev(j)))
+		{
+			*j = std::move(*std::prev(j));
+			--j;
+		}
+		*j = std::move(val);
+	}
+}
+
+template<class Iter>
+void partial_insertion_sort(Iter begin, Iter mid, Iter end)
+{
+	partial_insertion_sort(begin, mid, end, std::less< typename std::iterator_traits<Iter>::value_type >());
+}
+
+///
+/// Same result as partial_insertion_sort with a max-heap over the prefix, O(n log k) worst case
+///
+template<class Iter, class Comp>
+void partial_heap_sort(Iter begin, Iter mid, Iter end, Comp comp_lt)
+{
+	const size_t len = mid - begin;
+	if(len == 0)
+	{
+		return;
+	}
+
+	for(size_t i = len / 2; i > 0; i--)
+	{
+		heap_sift_down(begin, i - 1, len, comp_lt);
+	}
+
+	for(Iter i = mid; i != end; ++i)
+	{
+		if(comp_lt(*i, *begin))
+		{
+			std::iter_swap(i, begin);
+			heap_sift_down(begin, 0, len, comp_lt);
+		}
+	}
+
+	for(size_t i = len - 1; i > 0; i--)
+	{
+		std::iter_swap(begin, begin + i);
+		heap_sift_down(begin, 0, i, comp_lt);
+	}
+}
+
+template<class Iter>
+void partial_heap_sort(Iter begin, Iter mid, Iter end)
+{
+	partial_heap_sort(begin, mid, end, std::less< typename std::iterator_traits<Iter>::value_type >());
+}
+
+///
+/// Like std::nth_element, put the element that sorts to nth there, with nothing greater before it and nothing less after it
+/// Median of three quickselect using the intro_sort partition, falling back to partial_heap_sort past 2 log2(n) levels
+/// O(n) expected, O(n log n) worst case, in place with no allocation or recursion, not stable
+///
+template<class Iter, class Comp>
+void intro_select(Iter begin, Iter nth, Iter end, Comp comp_lt)
+{
+	if(nth == end)
+	{
+		return;
+	}
+
+	size_t depth_limit = 0;
+	for(size_t n = end - begin; n > 1; n >>= 1)
+	{
+		depth_limit += 2;
+	}
+
+	while(size_t(end - begin) > INTRO_SORT_CUTOFF)
+	{
+		if(depth_limit == 0)
+		{
+			partial_heap_sort(begin, std::next(nth), end, comp_lt);
+			return;
+		}
+		depth_limit--;
+
+		const Iter mid = begin + (end - begin) / 2;
+		intro_sort_median_to(begin, begin + 1, mid, end - 1, comp_lt);
+
+		//[begin, cut) is not greater than the pivot at *begin and [cut, end) is not less
+		const Iter cut = intro_sort_partition(begin, end, comp_lt);
+
+		if(nth < cut)
+		{
+			end = cut;
+		}
+		else
+		{
+			begin = cut;
+		}
+	}
+
+	insertion_sort(begin, end, comp_lt);
+}
+
+template<class Iter>
+void intro_select(Iter begin, Iter nth, Iter end)
+{
+	intro_select(begin, nth, end, std::less< typename std::iterator_traits<Iter>::value_type >());
+}
+
+///
+/// Streaming collector of the K elements that sort first under Comp, eg the K largest with std::greater
+/// A fixed size max-heap, each push is one comparison against the worst kept element unless it is kept, then O(log K)
+/// No allocation
+///
+template<typename T, size_t K, typename Comp = std::less<T>>
+class Top_k
+{
+	static_assert(K > 0, "Top_k needs room for at least one element");
+
+public:
+
+	Top_k() : m_size(0), m_comp()
+	{
+
+	}
+
+	explicit Top_k(const Comp& comp_lt) : m_size(0), m_comp(comp_lt)
+	{
+
+	}
+
+	///
+	/// Offer x, returns true if it was kept
+	///
+	bool push(const T& x)
+	{
+		if(m_size < K)
+		{
+			m_heap[m_size] = x;
+			sift_up(m_size);
+			m_size++;
+			return true;
+		}
+
+		if(!m_comp(x, m_heap[0]))
+		{
+			return false;
+		}
+
+		m_heap[0] = x;
+		heap_sift_down(m_heap.begin(), 0, m_size, m_comp);
+		return true;
+	}
+
+	bool push(T&& x)
+	{
+		if(m_size < K)
+		{
+			m_heap[m_size] = std::move(x);
+			sift_up(m_size);
+			m_size++;
+			return true;
+		}
+
+		if(!m_comp(x, m_heap[0]))
+		{
+			return false;
+		}
+
+		m_heap[0] = std::move(x);
+		heap_sift_down(m_heap.begin(), 0, m_size, m_comp);
+		return true;
+	}
+
+	template<class Iter>
+	void push(Iter begin, Iter end)
+	{
+		for(; begin != end; ++begin)
+		{
+			push(*begin);
+		}
+	}
+
+	///
+	/// The element that sorts last of those kept, the bar a new element has to beat once full
+	///
+	const T& top() const
+	{
+		return m_heap[0];
+	}
+
+	///
+	/// Copy out the kept elements in sorted order, out must hold size() elements, returns size()
+	///
+	size_t get_sorted(T* const out) const
+	{
+		std::copy(begin(), end(), out);
+		heap_sort(out, out + m_size, m_comp);
+		return m_size;
+	}
+
+	//kept elements in heap order
+	const T* begin() const
+	{
+		return m_heap.data();
+	}
+	const T* end() const
+	{
+		return m_heap.data() + m_size;
+	}
+
+	size_t size() const
+	{
+		return m_size;
+	}
+
+	bool empty() const
+	{
+		return m_size == 0;
+	}
+
+	bool full() const
+	{
+		return m_size == K;
+	}
+
+	static constexpr size_t capacity()
+	{
+		return K;
+	}
+
+	void clear()
+	{
+		m_size = 0;
+	}
+
+protected:
+
+	void sift_up(size_t idx)
+	{
+		T val = std::move(m_heap[idx]);
+
+		while(idx > 0)
+		{
+			const size_t parent = (idx - 1) / 2;
+			if(!m_comp(m_heap[parent], val))
+			{
+				break;
+			}
+
+			m_heap[idx] = std::move(m_heap[parent]);
+			idx = parent;
+		}
+
+		m_heap[idx] = std::move(val);
+	}
+
+	std::array<T, K> m_heap;
+	size_t m_size;
+	Comp m_comp;
+};
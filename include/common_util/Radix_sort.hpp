@@ -0,0 +1,279 @@
+/**
+ * @brief radix_sort and radix_sort_in_place
+ * @author Jacob Schloss <jacob@schloss.io>
+ * @copyright Copyright (c) 2019 Jacob Schloss. All rights reserved.
+ * @license Licensed under the 3-Clause BSD license. See LICENSE for details
+*/
+
+#pragma once
+
+#include "common_util/Byte_util.hpp"
+#include "common_util/Insertion_sort.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+//buckets at or below this size are finished with insertion_sort by radix_sort_in_place
+constexpr size_t RADIX_SORT_SMALL = 64;
+
+//Key extractor for sorting integers by value
+struct Radix_identity
+{
+	template<typename T>
+	T operator()(const T& x) const
+	{
+		return x;
+	}
+};
+
+///
+/// Map a key to an unsigned type with the same order, signed keys get their sign bit flipped
+///
+template<typename K>
+struct Radix_key
+{
+	static_assert(std::is_integral<K>::value, "radix sort keys must be integers");
+
+	typedef typename std::make_unsigned<K>::type type;
+
+	static constexpr type map(const K k)
+	{
+		return std::is_signed<K>::value ? type(type(k) ^ (type(1) << (8U * sizeof(K) - 1U))) : type(k);
+	}
+};
+
+template<typename T, typename Key_fn>
+struct Radix_key_of
+{
+	typedef typename std::decay<decltype(std::declval<Key_fn>()(std::declval<const T&>()))>::type key_type;
+	typedef typename Radix_key<key_type>::type type;
+
+	static type get(Key_fn& key_fn, const T& x)
+	{
+		return Radix_key<key_type>::map(key_fn(x));
+	}
+};
+
+template<size_t B, typename U>
+inline uint8_t radix_digit(const U k)
+{
+	return Byte_util::get_b<B>(k);
+}
+
+typedef std::array<size_t, 256> Radix_histogram;
+
+template<typename U>
+inline void radix_count_bytes(const U, Radix_histogram* const, std::integral_constant<size_t, size_t(-1)>)
+{
+
+}
+
+///
+/// Histogram every byte of every key in one read of the data
+///
+template<typename U, size_t B>
+inline void radix_count_bytes(const U k, Radix_histogram* const counts, std::integral_constant<size_t, B>)
+{
+	counts[B][radix_digit<B>(k)]++;
+	radix_count_bytes(k, counts, std::integral_constant<size_t, B - 1>());
+}
+
+///
+/// One stable counting sort pass on byte B from src to dst
+///
+template<size_t B, typename T, typename Key_fn>
+void radix_lsd_pass(T* const src, T* const dst, const size_t n, Key_fn& key_fn, const Radix_histogram& counts)
+{
+	Radix_histogram offsets;
+	size_t sum = 0;
+	for(size_t d = 0; d < 256; d++)
+	{
+		offsets[d] = sum;
+		sum += counts[d];
+	}
+
+	for(size_t i = 0; i < n; i++)
+	{
+		const uint8_t d = radix_digit<B>(Radix_key_of<T, Key_fn>::get(key_fn, src[i]));
+		dst[offsets[d]] = std::move(src[i]);
+		offsets[d]++;
+	}
+}
+
+template<typename T, typename Key_fn>
+inline void radix_lsd_passes(T** const, T** const, const size_t, Key_fn&, const Radix_histogram* const, std::integral_constant<size_t, size_t(-1)>)
+{
+
+}
+
+template<typename T, typename Key_fn, size_t B>
+inline void radix_lsd_passes(T** const src, T** const dst, const size_t n, Key_fn& key_fn, const Radix_histogram* const counts, std::integral_constant<size_t, B>)
+{
+	radix_lsd_passes(src, dst, n, key_fn, counts, std::integral_constant<size_t, B - 1>());
+
+	//every key has the same digit, the pass would only copy
+	const uint8_t first_digit = radix_digit<B>(Radix_key_of<T, Key_fn>::get(key_fn, (*src)[0]));
+	if(counts[B][first_digit] == n)
+	{
+		return;
+	}
+
+	radix_lsd_pass<B>(*src, *dst, n, key_fn, counts[B]);
+	std::swap(*src, *dst);
+}
+
+///
+/// Stable LSD radix sort of n elements by key_fn(element), an integer of any width
+/// scratch must hold n elements, no allocation
+/// One pass to histogram all bytes, then one scatter per byte where the keys differ
+///
+template<typename T, typename Key_fn>
+void radix_sort(T* const data, T* const scratch, const size_t n, Key_fn key_fn)
+{
+	typedef typename Radix_key_of<T, Key_fn>::type U;
+	constexpr size_t NUM_BYTES = sizeof(U);
+
+	if(n < 2)
+	{
+		return;
+	}
+
+	Radix_histogram counts[NUM_BYTES];
+	for(Radix_histogram& c : counts)
+	{
+		c.fill(0);
+	}
+
+	for(size_t i = 0; i < n; i++)
+	{
+		radix_count_bytes(Radix_key_of<T, Key_fn>::get(key_fn, data[i]), counts, std::integral_constant<size_t, NUM_BYTES - 1>());
+	}
+
+	T* src = data;
+	T* dst = scratch;
+	radix_lsd_passes(&src, &dst, n, key_fn, counts, std::integral_constant<size_t, NUM_BYTES - 1>());
+
+	//odd number of passes
+	if(src != data)
+	{
+		std::move(src, src + n, data);
+	}
+}
+
+template<typename T>
+void radix_sort(T* const data, T* const scratch, const size_t n)
+{
+	radix_sort(data, scratch, n, Radix_identity());
+}
+
+template<typename T, typename Key_fn>
+void radix_msd_insertion_sort(T* const data, const size_t n, Key_fn& key_fn)
+{
+	insertion_sort(data, data + n, [&key_fn](const T& lhs, const T& rhs)
+	{
+		return Radix_key_of<T, Key_fn>::get(key_fn, lhs) < Radix_key_of<T, Key_fn>::get(key_fn, rhs);
+	});
+}
+
+template<typename T, typename Key_fn, size_t B>
+void radix_american_flag(T* const data, const size_t n, Key_fn& key_fn, std::integral_constant<size_t, B>);
+
+template<typename T, typename Key_fn>
+inline void radix_american_flag(T* const, const size_t, Key_fn&, std::integral_constant<size_t, size_t(-1)>)
+{
+
+}
+
+///
+/// In place MSD pass on byte B, then each bucket on byte B - 1
+///
+template<typename T, typename Key_fn, size_t B>
+void radix_american_flag(T* const data, const size_t n, Key_fn& key_fn, std::integral_constant<size_t, B>)
+{
+	if(n <= RADIX_SORT_SMALL)
+	{
+		radix_msd_insertion_sort(data, n, key_fn);
+		return;
+	}
+
+	Radix_histogram counts;
+	counts.fill(0);
+	for(size_t i = 0; i < n; i++)
+	{
+		counts[radix_digit<B>(Radix_key_of<T, Key_fn>::get(key_fn, data[i]))]++;
+	}
+
+	const uint8_t first_digit = radix_digit<B>(Radix_key_of<T, Key_fn>::get(key_fn, data[0]));
+	if(counts[first_digit] == n)
+	{
+		radix_american_flag(data, n, key_fn, std::integral_constant<size_t, B - 1>());
+		return;
+	}
+
+	//next[d] is the next unplaced slot of bucket d, ends[d] one past the bucket
+	Radix_histogram next;
+	Radix_histogram ends;
+	size_t sum = 0;
+	for(size_t d = 0; d < 256; d++)
+	{
+		next[d] = sum;
+		sum += counts[d];
+		ends[d] = sum;
+	}
+
+	//swap each element into its bucket until every bucket is filled
+	for(size_t b = 0; b < 256; b++)
+	{
+		while(next[b] < ends[b])
+		{
+			const uint8_t d = radix_digit<B>(Radix_key_of<T, Key_fn>::get(key_fn, data[next[b]]));
+			if(d == b)
+			{
+				next[b]++;
+			}
+			else
+			{
+				using std::swap;
+				swap(data[next[b]], data[next[d]]);
+				next[d]++;
+			}
+		}
+	}
+
+	size_t begin = 0;
+	for(size_t b = 0; b < 256; b++)
+	{
+		if(counts[b] > 1)
+		{
+			radix_american_flag(data + begin, counts[b], key_fn, std::integral_constant<size_t, B - 1>());
+		}
+		begin += counts[b];
+	}
+}
+
+///
+/// In place American flag MSD radix sort, for when there is no scratch buffer
+/// Not stable, recursion is at most one level per key byte
+///
+template<typename T, typename Key_fn>
+void radix_sort_in_place(T* const data, const size_t n, Key_fn key_fn)
+{
+	typedef typename Radix_key_of<T, Key_fn>::type U;
+
+	if(n < 2)
+	{
+		return;
+	}
+
+	radix_american_flag(data, n, key_fn, std::integral_constant<size_t, sizeof(U) - 1>());
+}
+
+template<typename T>
+void radix_sort_in_place(T* const data, const size_t n)
+{
+	radix_sort_in_place(data, n, Radix_identity());
+}
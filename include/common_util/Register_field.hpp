@@ -0,0 +1,227 @@
+/**
+ * @brief Reg_field and Reg
+ * @author Jacob Schloss <jacob@schloss.io>
+ * @copyright Copyright (c) 2019 Jacob Schloss. All rights reserved.
+ * @license Licensed under the 3-Clause BSD license. See LICENSE for details
+*/
+
+#pragma once
+
+#include "common_util/Register_util.hpp"
+
+#include <cstdint>
+#include <type_traits>
+
+///
+/// A WIDTH bit field starting at bit OFFSET of a register
+/// Masks and shifts are all resolved at compile time
+///
+template<uint8_t OFS, uint8_t WID>
+class Reg_field
+{
+public:
+
+	static_assert(WID != 0, "Reg_field must be at least 1 bit wide");
+	static_assert((OFS + WID) <= 64, "Reg_field does not fit in 64 bits");
+
+	static constexpr uint8_t OFFSET = OFS;
+	static constexpr uint8_t WIDTH  = WID;
+
+	template<typename T>
+	static constexpr T mask()
+	{
+		return T((~uint64_t(0) >> (64U - WIDTH)) << OFFSET);
+	}
+
+	//extra high bits of val are dropped
+	template<typename T>
+	static constexpr T pack(const T val)
+	{
+		return T(uint64_t(val) << OFFSET) & mask<T>();
+	}
+
+	template<typename T>
+	static constexpr T extract(const T reg)
+	{
+		return T((reg & mask<T>()) >> OFFSET);
+	}
+};
+
+template<uint8_t OFS, uint8_t WID>
+constexpr uint8_t Reg_field<OFS, WID>::OFFSET;
+template<uint8_t OFS, uint8_t WID>
+constexpr uint8_t Reg_field<OFS, WID>::WIDTH;
+
+//Maps a field to the value type of a register, so a pack of fields can declare a matching pack of values
+template<typename F, typename T>
+struct Field_value
+{
+	typedef T type;
+};
+
+///
+/// Compile time operations over a list of Reg_field in a register of type T
+///
+template<typename T, typename... Fields>
+class Reg_field_set;
+
+template<typename T>
+class Reg_field_set<T>
+{
+public:
+	static constexpr T mask()
+	{
+		return 0;
+	}
+
+	static constexpr T pack()
+	{
+		return 0;
+	}
+
+	static constexpr bool fits()
+	{
+		return true;
+	}
+
+	static constexpr bool disjoint()
+	{
+		return true;
+	}
+
+	template<typename G>
+	static constexpr bool contains()
+	{
+		return false;
+	}
+
+	template<typename... G>
+	static constexpr bool subset_of()
+	{
+		return true;
+	}
+};
+
+template<typename T, typename F, typename... Rest>
+class Reg_field_set<T, F, Rest...>
+{
+public:
+
+	typedef Reg_field_set<T, Rest...> Tail;
+
+	static constexpr T mask()
+	{
+		return F::template mask<T>() | Tail::mask();
+	}
+
+	static constexpr T pack(const T val, const typename Field_value<Rest, T>::type... rest)
+	{
+		return F::template pack<T>(val) | Tail::pack(rest...);
+	}
+
+	static constexpr bool fits()
+	{
+		return ((F::OFFSET + F::WIDTH) <= (8U * sizeof(T))) && Tail::fits();
+	}
+
+	static constexpr bool disjoint()
+	{
+		return ((F::template mask<T>() & Tail::mask()) == 0) && Tail::disjoint();
+	}
+
+	template<typename G>
+	static constexpr bool contains()
+	{
+		return std::is_same<F, G>::value || Tail::template contains<G>();
+	}
+
+	//every field in this set is one of G
+	template<typename... G>
+	static constexpr bool subset_of()
+	{
+		return Reg_field_set<T, G...>::template contains<F>() && Tail::template subset_of<G...>();
+	}
+};
+
+///
+/// A register R with a known field layout, accessed through Register_traits<R>
+/// Writing several fields at once is one read-modify-write of the register
+///
+/// typedef Reg_field<0, 1> EN;
+/// typedef Reg_field<1, 2> MODE;
+/// typedef Reg_field<4, 4> DIV;
+/// Reg<uint32_t, EN, MODE, DIV> ctrl(&PERIPH->CTRL);
+/// ctrl.write<EN, MODE, DIV>(1, 3, 7);
+///
+template<typename R, typename... Fields>
+class Reg_base
+{
+public:
+
+	typedef typename Register_traits<R>::value_type T;
+
+	static_assert(std::is_unsigned<T>::value, "Reg register type must be unsigned");
+	static_assert(Reg_field_set<T, Fields...>::fits(), "Reg field does not fit in the register type");
+	static_assert(Reg_field_set<T, Fields...>::disjoint(), "Reg fields overlap");
+
+	explicit Reg_base(R* const reg) : m_reg(reg)
+	{
+
+	}
+
+	///
+	/// Value of the given fields, with all other bits 0
+	///
+	template<typename... F>
+	static constexpr T value(const typename Field_value<F, T>::type... vals)
+	{
+		static_assert(Reg_field_set<T, F...>::template subset_of<Fields...>(), "Field is not part of this Reg");
+		static_assert(Reg_field_set<T, F...>::disjoint(), "Field listed twice");
+
+		return Reg_field_set<T, F...>::pack(vals...);
+	}
+
+	///
+	/// Update the given fields in one read-modify-write, leaving other bits alone
+	///
+	template<typename... F>
+	void write(const typename Field_value<F, T>::type... vals) const
+	{
+		Register_util::mask_set_bits(m_reg, Reg_field_set<T, F...>::mask(), value<F...>(vals...));
+	}
+
+	///
+	/// Store the given fields without reading the register first, all other bits are written 0
+	///
+	template<typename... F>
+	void overwrite(const typename Field_value<F, T>::type... vals) const
+	{
+		Register_traits<R>::write(m_reg, value<F...>(vals...));
+	}
+
+	template<typename F>
+	T read() const
+	{
+		static_assert(Reg_field_set<T, F>::template subset_of<Fields...>(), "Field is not part of this Reg");
+
+		return F::template extract<T>(Register_traits<R>::read(m_reg));
+	}
+
+	T read_raw() const
+	{
+		return Register_traits<R>::read(m_reg);
+	}
+
+	R* get_reg() const
+	{
+		return m_reg;
+	}
+
+protected:
+
+	R* const m_reg;
+};
+
+//A memory mapped register of type T
+template<typename T, typename... Fields>
+using Reg = Reg_base<volatile T, Fields...>;
@@ -0,0 +1,209 @@
+/**
+ * @brief Register_trace_buffer
+ * @author Jacob Schloss <jacob@schloss.io>
+ * @copyright Copyright (c) 2019 Jacob Schloss. All rights reserved.
+ * @license Licensed under the 3-Clause BSD license. See LICENSE for details
+*/
+
+#pragma once
+
+#include "common_util/Register_util.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+class Stack_string_base;
+
+///
+/// One traced Register_util call
+///
+struct Register_trace_record
+{
+	//position in the trace, wraps at 2^32
+	uint32_t seq;
+	uint32_t timestamp;
+	uintptr_t addr;
+	uint64_t old_val;
+	uint64_t new_val;
+	Register_op op;
+};
+
+///
+/// Post-mortem decoding of trace records
+///
+class Register_trace_decoder
+{
+public:
+
+	//longest line format() appends
+	static constexpr size_t MAX_LINE_LEN = 8 + 1 + 8 + 1 + 13 + 1 + 16 + 1 + 16 + 4 + 16 + 1;
+
+	static const char* op_name(const Register_op op);
+
+	///
+	/// Append one line to str
+	/// "<seq> <timestamp> <op> <addr> <old> -> <new>\n", numbers in hex
+	/// Returns false and appends nothing if str does not have room
+	///
+	static bool format(const Register_trace_record& rec, Stack_string_base* const str);
+};
+
+//Timestamp source that always returns 0, the records are still ordered by seq
+class No_trace_timestamp
+{
+public:
+	static inline uint32_t now()
+	{
+		return 0;
+	}
+};
+
+///
+/// Lock free ring of the last N Register_util calls
+/// Any number of threads or ISRs may record, a record costs one atomic increment, one compare and swap and a few stores
+/// A writer claims its slot by swapping the stamp to busy, if another writer N records away still holds it the record is dropped
+/// Each slot carries a stamp so snapshot() can skip slots overwritten while it was reading them
+///
+template<size_t N, typename Timestamp = No_trace_timestamp>
+class Register_trace_buffer
+{
+public:
+
+	static_assert((N != 0) && ((N & (N - 1)) == 0), "Register_trace_buffer size must be a power of 2");
+
+	Register_trace_buffer()
+	{
+		clear();
+	}
+
+	//not safe against concurrent record()
+	void clear()
+	{
+		for(Slot& slot : m_slots)
+		{
+			slot.stamp.store(STAMP_EMPTY, std::memory_order_relaxed);
+		}
+
+		m_dropped.store(0, std::memory_order_relaxed);
+		m_head.store(0, std::memory_order_release);
+	}
+
+	template<typename T>
+	inline void record(const Register_op op, const volatile void* const addr, const T old_val, const T new_val)
+	{
+		const uint32_t pos = m_head.fetch_add(1, std::memory_order_relaxed);
+		Slot& slot = m_slots[pos & (N - 1U)];
+
+		//claim the slot, a writer that wrapped around onto it may not have finished
+		uint32_t stamp = slot.stamp.load(std::memory_order_relaxed);
+		if((stamp == STAMP_BUSY) || !slot.stamp.compare_exchange_strong(stamp, STAMP_BUSY, std::memory_order_acquire, std::memory_order_relaxed))
+		{
+			m_dropped.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+
+		slot.rec.seq = pos;
+		slot.rec.timestamp = Timestamp::now();
+		slot.rec.addr = reinterpret_cast<uintptr_t>(addr);
+		slot.rec.old_val = uint64_t(old_val);
+		slot.rec.new_val = uint64_t(new_val);
+		slot.rec.op = op;
+
+		slot.stamp.store(stamp_of(pos), std::memory_order_release);
+	}
+
+	///
+	/// Copy out up to max of the most recent records, oldest first
+	/// Returns the number copied
+	///
+	size_t snapshot(Register_trace_record* const out, const size_t max) const
+	{
+		const uint32_t head = m_head.load(std::memory_order_acquire);
+
+		const uint32_t avail = (head < N) ? head : uint32_t(N);
+		const uint32_t num = (avail < max) ? avail : uint32_t(max);
+
+		size_t count = 0;
+		for(uint32_t pos = head - num; pos != head; pos++)
+		{
+			const Slot& slot = m_slots[pos & (N - 1U)];
+
+			const uint32_t stamp = slot.stamp.load(std::memory_order_acquire);
+			if(stamp != stamp_of(pos))
+			{
+				//being written, already overwritten or dropped
+				continue;
+			}
+
+			const Register_trace_record rec = slot.rec;
+
+			std::atomic_thread_fence(std::memory_order_acquire);
+			if((slot.stamp.load(std::memory_order_relaxed) != stamp) || (rec.seq != pos))
+			{
+				continue;
+			}
+
+			out[count] = rec;
+			count++;
+		}
+
+		return count;
+	}
+
+	//total records ever made, including ones that have been overwritten or dropped
+	uint32_t total() const
+	{
+		return m_head.load(std::memory_order_relaxed);
+	}
+
+	//records dropped because another writer held the slot
+	uint32_t dropped() const
+	{
+		return m_dropped.load(std::memory_order_relaxed);
+	}
+
+	constexpr size_t capacity() const
+	{
+		return N;
+	}
+
+protected:
+
+	//a finished slot holds stamp_of(seq), always odd
+	static constexpr uint32_t STAMP_EMPTY = 0;
+	static constexpr uint32_t STAMP_BUSY = 2;
+
+	static constexpr uint32_t stamp_of(const uint32_t pos)
+	{
+		return (pos << 1) | 1U;
+	}
+
+	struct Slot
+	{
+		std::atomic<uint32_t> stamp;
+		Register_trace_record rec;
+	};
+
+	std::array<Slot, N> m_slots;
+	std::atomic<uint32_t> m_head;
+	std::atomic<uint32_t> m_dropped;
+};
+
+///
+/// Trace policy for Register_util_base that records into the buffer at BUF
+///
+/// Register_trace_buffer<256> g_reg_trace;
+/// typedef Register_util_base< Register_trace_to_buffer<Register_trace_buffer<256>, &g_reg_trace> > Traced_register_util;
+///
+template<typename Buffer, Buffer* BUF>
+class Register_trace_to_buffer
+{
+public:
+	template<typename T>
+	static inline void record(const Register_op op, const volatile void* const addr, const T old_val, const T new_val)
+	{
+		BUF->record(op, addr, old_val, new_val);
+	}
+};
@@ -0,0 +1,199 @@
+/**
+ * @brief Register_txn
+ * @author Jacob Schloss <jacob@schloss.io>
+ * @copyright Copyright (c) 2019 Jacob Schloss. All rights reserved.
+ * @license Licensed under the 3-Clause BSD license. See LICENSE for details
+*/
+
+#pragma once
+
+#include "common_util/Insertion_sort.hpp"
+#include "common_util/Register_util.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <type_traits>
+
+///
+/// Collects up to N register writes and read-modify-writes, then applies them in one go
+/// Operations on the same register are merged, so each register is accessed at most once per segment
+/// Within a segment registers are written in address order, barrier() starts a new segment that is never reordered with the one before
+///
+/// Register_txn<uint32_t, 8> txn;
+/// txn.mask_set_bits(&PERIPH->CR1, MODE_MASK, MODE_2);
+/// txn.set_bits(&PERIPH->CR2, IRQ_EN);
+/// txn.barrier();
+/// txn.set_bits(&PERIPH->CR1, EN);
+/// txn.commit();
+///
+template<typename T, size_t N, typename R = volatile T>
+class Register_txn
+{
+public:
+
+	static_assert(std::is_same<T, typename Register_traits<R>::value_type>::value, "Value type does not match the register");
+
+	Register_txn()
+	{
+		clear();
+	}
+
+	///
+	/// Store val, the register is not read
+	/// Returns false if the transaction is full
+	///
+	bool write(R* const reg, const T val)
+	{
+		return mask_set_bits(reg, T(~T(0)), val);
+	}
+
+	///
+	/// Same result as Register_util::mask_set_bits
+	///
+	bool mask_set_bits(R* const reg, const T mask, const T x)
+	{
+		for(size_t i = m_segment_begin; i < m_count; i++)
+		{
+			Entry& e = m_entries[i];
+			if(e.reg == reg)
+			{
+				//(((r & ~m1) | x1) & ~m2) | x2 == (r & ~(m1 | m2)) | ((x1 & ~m2) | x2)
+				e.value = T((e.value & T(~mask)) | x);
+				e.mask = T(e.mask | mask);
+				return true;
+			}
+		}
+
+		if(m_count == N)
+		{
+			return false;
+		}
+
+		Entry& e = m_entries[m_count];
+		e.reg = reg;
+		e.mask = mask;
+		e.value = x;
+		e.segment = m_segment;
+		m_count++;
+
+		return true;
+	}
+
+	bool set_bits(R* const reg, const T x)
+	{
+		return mask_set_bits(reg, x, x);
+	}
+
+	bool clear_bits(R* const reg, const T x)
+	{
+		return mask_set_bits(reg, x, T(0));
+	}
+
+	///
+	/// Operations after this are applied after all the ones before it, with a memory barrier in between
+	///
+	void barrier()
+	{
+		if(m_segment_begin != m_count)
+		{
+			m_segment_begin = m_count;
+			m_segment++;
+		}
+	}
+
+	///
+	/// Apply everything and clear the transaction
+	///
+	void commit()
+	{
+		size_t seg_begin = 0;
+		while(seg_begin < m_count)
+		{
+			size_t seg_end = seg_begin + 1;
+			while((seg_end < m_count) && (m_entries[seg_end].segment == m_entries[seg_begin].segment))
+			{
+				seg_end++;
+			}
+
+			if(seg_begin != 0)
+			{
+				std::atomic_thread_fence(std::memory_order_seq_cst);
+			}
+
+			insertion_sort(m_entries.begin() + seg_begin, m_entries.begin() + seg_end, Entry_addr_lt());
+
+			for(size_t i = seg_begin; i < seg_end; i++)
+			{
+				apply(m_entries[i]);
+			}
+
+			seg_begin = seg_end;
+		}
+
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+
+		clear();
+	}
+
+	void clear()
+	{
+		m_count = 0;
+		m_segment_begin = 0;
+		m_segment = 0;
+	}
+
+	size_t size() const
+	{
+		return m_count;
+	}
+
+	bool empty() const
+	{
+		return m_count == 0;
+	}
+
+	constexpr size_t capacity() const
+	{
+		return N;
+	}
+
+protected:
+
+	struct Entry
+	{
+		R* reg;
+		T mask;
+		T value;
+		size_t segment;
+	};
+
+	struct Entry_addr_lt
+	{
+		bool operator()(const Entry& lhs, const Entry& rhs) const
+		{
+			return std::less<R*>()(lhs.reg, rhs.reg);
+		}
+	};
+
+	static void apply(const Entry& e)
+	{
+		if(e.mask == T(~T(0)))
+		{
+			//every bit is overwritten, skip the read
+			Register_traits<R>::write(e.reg, e.value);
+		}
+		else
+		{
+			Register_util::mask_set_bits(e.reg, e.mask, e.value);
+		}
+	}
+
+	std::array<Entry, N> m_entries;
+	size_t m_count;
+
+	size_t m_segment_begin;
+	size_t m_segment;
+};
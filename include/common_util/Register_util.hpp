@@ -7,55 +7,480 @@
 
 #pragma once
 
-class Register_util
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+///
+/// Timeout policies for the bounded Register_util::wait_until_* overloads
+/// expired() is checked after each failed poll, with the number of failed polls so far
+///
+
+//Never expire, same as the unbounded wait
+class No_timeout
 {
 public:
+	bool expired(const uint32_t) const
+	{
+		return false;
+	}
+};
 
-	template<typename T>
-	static inline void mask_set_bits(volatile T* const reg, const T mask, const T x)
+//Give up after max_polls reads that did not meet the condition
+class Spin_budget
+{
+public:
+	explicit Spin_budget(const uint32_t max_polls) : m_max_polls(max_polls)
 	{
-		*reg = ((*reg) & (~mask)) | x;
+
 	}
 
-	template<typename T>
-	static inline void set_bits(volatile T* const reg, const T x)
+	bool expired(const uint32_t polls) const
 	{
-		*reg = (*reg) | x;
+		return polls >= m_max_polls;
 	}
 
-	template<typename T>
-	static inline void clear_bits(volatile T* const reg, const T x)
+protected:
+	uint32_t m_max_polls;
+};
+
+//Give up once Clock::now() reaches the deadline
+//Clock needs a static now(), std::chrono::steady_clock or a wrapper around a hardware timer
+template<typename Clock>
+class Deadline
+{
+public:
+	typedef typename Clock::time_point time_point;
+	typedef typename Clock::duration   duration;
+
+	explicit Deadline(const time_point& deadline) : m_deadline(deadline)
 	{
-		*reg = (*reg) & (~x);
+
 	}
 
-	template<typename T>
-	static inline void wait_until_set(volatile T* const reg, const T x)
+	static Deadline from_now(const duration& timeout)
+	{
+		return Deadline(Clock::now() + timeout);
+	}
+
+	bool expired(const uint32_t) const
+	{
+		return !(Clock::now() < m_deadline);
+	}
+
+protected:
+	time_point m_deadline;
+};
+
+///
+/// Backoff policies, pause() is called between polls
+///
+
+//Poll as fast as possible
+class No_backoff
+{
+public:
+	void pause()
+	{
+
+	}
+};
+
+//Spin hint to the core, pause on x86 and yield on ARM
+class Cpu_relax_backoff
+{
+public:
+	static inline void cpu_relax()
+	{
+#if defined(__x86_64__) || defined(__i386__)
+		__builtin_ia32_pause();
+#elif defined(__arm__) || defined(__aarch64__)
+		__asm__ volatile("yield" ::: "memory");
+#else
+		__asm__ volatile("" ::: "memory");
+#endif
+	}
+
+	void pause()
+	{
+		cpu_relax();
+	}
+};
+
+//Double the number of cpu_relax between polls each time, up to MAX_RELAX
+//Trades wake up latency for fewer bus reads on long waits
+template<uint32_t MAX_RELAX = 1024>
+class Exp_backoff
+{
+public:
+	static_assert(MAX_RELAX != 0, "MAX_RELAX must be at least 1");
+
+	Exp_backoff() : m_relax(1)
+	{
+
+	}
+
+	void pause()
 	{
-		while(((*reg) & x) == 0)
+		for(uint32_t i = 0; i < m_relax; i++)
 		{
+			Cpu_relax_backoff::cpu_relax();
+		}
 
+		if(m_relax < MAX_RELAX)
+		{
+			m_relax = ((m_relax * 2U) < MAX_RELAX) ? (m_relax * 2U) : MAX_RELAX;
 		}
 	}
 
-	template<typename T>
-	static inline void wait_until_clear(volatile T* const reg, const T x)
+protected:
+	uint32_t m_relax;
+};
+
+///
+/// Spin statistics, record() is called once per wait with the number of failed polls
+///
+
+class No_spin_stats
+{
+public:
+	void record(const uint32_t, const bool)
 	{
-		while(((*reg) & x) != 0)
+
+	}
+};
+
+///
+/// Log2 histogram of failed polls per wait
+/// Bucket 0 is satisfied on the first poll, bucket i holds [2^(i-1), 2^i), the last bucket is open ended
+///
+template<size_t N>
+class Spin_histogram
+{
+public:
+	static_assert(N >= 2, "Spin_histogram needs at least 2 buckets");
+
+	Spin_histogram()
+	{
+		clear();
+	}
+
+	void clear()
+	{
+		m_buckets.fill(0);
+		m_timeouts = 0;
+		m_max_polls = 0;
+	}
+
+	void record(const uint32_t polls, const bool success)
+	{
+		m_buckets[bucket_index(polls)]++;
+
+		if(!success)
+		{
+			m_timeouts++;
+		}
+
+		if(polls > m_max_polls)
+		{
+			m_max_polls = polls;
+		}
+	}
+
+	static size_t bucket_index(const uint32_t polls)
+	{
+		if(polls == 0)
+		{
+			return 0;
+		}
+
+		const size_t idx = size_t(32 - __builtin_clz(polls));
+		return (idx < N) ? idx : (N - 1);
+	}
+
+	uint32_t bucket(const size_t idx) const
+	{
+		return m_buckets[idx];
+	}
+
+	uint32_t count() const
+	{
+		uint32_t sum = 0;
+		for(const uint32_t b : m_buckets)
 		{
-			
+			sum += b;
 		}
+		return sum;
+	}
+
+	uint32_t timeouts() const
+	{
+		return m_timeouts;
+	}
+
+	uint32_t max_polls() const
+	{
+		return m_max_polls;
 	}
 
+protected:
+	std::array<uint32_t, N> m_buckets;
+	uint32_t m_timeouts;
+	uint32_t m_max_polls;
+};
+
+///
+/// How Register_util and Reg access a register of type R
+/// The default is a plain T, always accessed as volatile so a T* that was not declared volatile still polls the bus
+/// Specialize for anything else, eg Sim_register
+///
+template<typename R>
+struct Register_traits
+{
+	typedef typename std::remove_cv<R>::type value_type;
+
+	static inline value_type read(R* const reg)
+	{
+		return *static_cast<volatile R*>(reg);
+	}
+
+	static inline void write(R* const reg, const value_type val)
+	{
+		*static_cast<volatile R*>(reg) = val;
+	}
+};
+
+///
+/// How Register_util waits poll a register of type R, the same as Register_traits<R>::read by default
+/// Specialize when read can return a cached value, eg Shadowed_register
+///
+template<typename R>
+struct Register_poll_traits
+{
+	static inline typename Register_traits<R>::value_type read(R* const reg)
+	{
+		return Register_traits<R>::read(reg);
+	}
+};
+
+///
+/// Operations reported to a Register_util trace policy
+///
+enum class Register_op : uint8_t
+{
+	MASK_SET_BITS,
+	SET_BITS,
+	CLEAR_BITS,
+	WAIT_SET,
+	WAIT_CLEAR,
+	WAIT_VALUE,
+	WAIT_TIMEOUT
+};
+
+///
+/// Trace policy that records nothing, Register_util compiles to plain register accesses
+/// A policy provides a static record(op, addr, old_val, new_val)
+/// For read-modify-writes old_val is the value read and new_val the value written
+/// For waits old_val is the first value read and new_val the last
+///
+class No_register_trace
+{
+public:
 	template<typename T>
-	static inline void wait_until_value(volatile T* const reg, const T mask, const T val)
+	static inline void record(const Register_op, const volatile void* const, const T, const T)
+	{
+
+	}
+};
+
+template<typename Trace>
+class Register_util_base
+{
+public:
+
+	template<typename T, typename R>
+	static inline void mask_set_bits(R* const reg, const T mask, const T x)
+	{
+		check_value_type<T, R>();
+
+		const T old_val = Register_traits<R>::read(reg);
+		const T new_val = (old_val & (~mask)) | x;
+		Register_traits<R>::write(reg, new_val);
+
+		Trace::record(Register_op::MASK_SET_BITS, reg, old_val, new_val);
+	}
+
+	template<typename T, typename R>
+	static inline void set_bits(R* const reg, const T x)
+	{
+		check_value_type<T, R>();
+
+		const T old_val = Register_traits<R>::read(reg);
+		const T new_val = old_val | x;
+		Register_traits<R>::write(reg, new_val);
+
+		Trace::record(Register_op::SET_BITS, reg, old_val, new_val);
+	}
+
+	template<typename T, typename R>
+	static inline void clear_bits(R* const reg, const T x)
+	{
+		check_value_type<T, R>();
+
+		const T old_val = Register_traits<R>::read(reg);
+		const T new_val = old_val & (~x);
+		Register_traits<R>::write(reg, new_val);
+
+		Trace::record(Register_op::CLEAR_BITS, reg, old_val, new_val);
+	}
+
+	template<typename T, typename R>
+	static inline void wait_until_set(R* const reg, const T x)
+	{
+		check_value_type<T, R>();
+
+		const T first_val = Register_poll_traits<R>::read(reg);
+		T val = first_val;
+		while((val & x) == 0)
+		{
+			val = Register_poll_traits<R>::read(reg);
+		}
+
+		Trace::record(Register_op::WAIT_SET, reg, first_val, val);
+	}
+
+	template<typename T, typename R>
+	static inline void wait_until_clear(R* const reg, const T x)
 	{
-		while(((*reg) & mask) != val)
+		check_value_type<T, R>();
+
+		const T first_val = Register_poll_traits<R>::read(reg);
+		T val = first_val;
+		while((val & x) != 0)
 		{
-			
+			val = Register_poll_traits<R>::read(reg);
 		}
+
+		Trace::record(Register_op::WAIT_CLEAR, reg, first_val, val);
+	}
+
+	template<typename T, typename R>
+	static inline void wait_until_value(R* const reg, const T mask, const T val)
+	{
+		check_value_type<T, R>();
+
+		const T first_val = Register_poll_traits<R>::read(reg);
+		T reg_val = first_val;
+		while((reg_val & mask) != val)
+		{
+			reg_val = Register_poll_traits<R>::read(reg);
+		}
+
+		Trace::record(Register_op::WAIT_VALUE, reg, first_val, reg_val);
+	}
+
+	///
+	/// Bounded waits
+	/// Returns false if timeout expired before the condition was met
+	/// eg wait_until_set(&REG, BIT, Spin_budget(1000), Cpu_relax_backoff(), &hist)
+	///
+	template<typename T, typename R, typename Timeout, typename Backoff = No_backoff, typename Stats = No_spin_stats>
+	static inline bool wait_until_set(R* const reg, const T x, Timeout timeout, Backoff backoff = Backoff(), Stats* const stats = nullptr)
+	{
+		check_value_type<T, R>();
+
+		const T first_val = Register_poll_traits<R>::read(reg);
+		T val = first_val;
+
+		uint32_t polls = 0;
+		for(;;)
+		{
+			if((val & x) != 0)
+			{
+				Trace::record(Register_op::WAIT_SET, reg, first_val, val);
+				return wait_done(true, polls, stats);
+			}
+
+			if(timeout.expired(polls + 1U))
+			{
+				Trace::record(Register_op::WAIT_TIMEOUT, reg, first_val, val);
+				return wait_done(false, polls + 1U, stats);
+			}
+
+			backoff.pause();
+			polls++;
+
+			val = Register_poll_traits<R>::read(reg);
+		}
+	}
+
+	template<typename T, typename R, typename Timeout, typename Backoff = No_backoff, typename Stats = No_spin_stats>
+	static inline bool wait_until_clear(R* const reg, const T x, Timeout timeout, Backoff backoff = Backoff(), Stats* const stats = nullptr)
+	{
+		return wait_until_masked(Register_op::WAIT_CLEAR, reg, x, T(0), timeout, backoff, stats);
+	}
+
+	template<typename T, typename R, typename Timeout, typename Backoff = No_backoff, typename Stats = No_spin_stats>
+	static inline bool wait_until_value(R* const reg, const T mask, const T val, Timeout timeout, Backoff backoff = Backoff(), Stats* const stats = nullptr)
+	{
+		return wait_until_masked(Register_op::WAIT_VALUE, reg, mask, val, timeout, backoff, stats);
 	}
 
 protected:
 
+	template<typename T, typename R>
+	static inline void check_value_type()
+	{
+		static_assert(std::is_same<T, typename Register_traits<R>::value_type>::value, "Value type does not match the register");
+	}
+
+	//bounded wait for (reg & mask) == val, traced as done_op
+	template<typename T, typename R, typename Timeout, typename Backoff, typename Stats>
+	static inline bool wait_until_masked(const Register_op done_op, R* const reg, const T mask, const T val, Timeout timeout, Backoff backoff, Stats* const stats)
+	{
+		check_value_type<T, R>();
+
+		const T first_val = Register_poll_traits<R>::read(reg);
+		T reg_val = first_val;
+
+		uint32_t polls = 0;
+		for(;;)
+		{
+			if((reg_val & mask) == val)
+			{
+				Trace::record(done_op, reg, first_val, reg_val);
+				return wait_done(true, polls, stats);
+			}
+
+			if(timeout.expired(polls + 1U))
+			{
+				Trace::record(Register_op::WAIT_TIMEOUT, reg, first_val, reg_val);
+				return wait_done(false, polls + 1U, stats);
+			}
+
+			backoff.pause();
+			polls++;
+
+			reg_val = Register_poll_traits<R>::read(reg);
+		}
+	}
+
+	template<typename Stats>
+	static inline bool wait_done(const bool success, const uint32_t polls, Stats* const stats)
+	{
+		if(stats)
+		{
+			stats->record(polls, success);
+		}
+
+		return success;
+	}
 };
+
+//Define COMMON_UTIL_REGISTER_TRACE_POLICY to a policy type, declared before this header, to trace every Register_util call
+#ifndef COMMON_UTIL_REGISTER_TRACE_POLICY
+#define COMMON_UTIL_REGISTER_TRACE_POLICY No_register_trace
+#endif
+
+typedef Register_util_base<COMMON_UTIL_REGISTER_TRACE_POLICY> Register_util;
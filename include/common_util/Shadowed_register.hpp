@@ -0,0 +1,124 @@
+/**
+ * @brief Shadowed_register
+ * @author Jacob Schloss <jacob@schloss.io>
+ * @copyright Copyright (c) 2019 Jacob Schloss. All rights reserved.
+ * @license Licensed under the 3-Clause BSD license. See LICENSE for details
+*/
+
+#pragma once
+
+#include "common_util/Register_util.hpp"
+
+///
+/// Write through cache of a register R holding a T
+/// Reads come from the local copy, so Register_util and Reg read-modify-write cost only the write
+/// Only for registers hardware does not change, or call sync() / invalidate() when it might have
+/// Register_util waits are the exception, each poll reads the register and reloads the shadow
+///
+template<typename T, typename R = volatile T>
+class Shadowed_register
+{
+public:
+
+	//shadow loaded on first read
+	explicit Shadowed_register(R* const reg) : m_reg(reg), m_shadow(0), m_valid(false)
+	{
+
+	}
+
+	//shadow starts at a known value, eg the reset value from the datasheet, without a read
+	Shadowed_register(R* const reg, const T initial) : m_reg(reg), m_shadow(initial), m_valid(true)
+	{
+
+	}
+
+	T read()
+	{
+		if(!m_valid)
+		{
+			sync();
+		}
+
+		return m_shadow;
+	}
+
+	void write(const T val)
+	{
+		Register_traits<R>::write(m_reg, val);
+		m_shadow = val;
+		m_valid = true;
+	}
+
+	///
+	/// Reload the shadow from the register now
+	///
+	void sync()
+	{
+		m_shadow = Register_traits<R>::read(m_reg);
+		m_valid = true;
+	}
+
+	///
+	/// Reload the shadow from the register on the next read
+	///
+	void invalidate()
+	{
+		m_valid = false;
+	}
+
+	///
+	/// Write the shadow to the register, eg after the peripheral was reset
+	///
+	void write_back()
+	{
+		Register_traits<R>::write(m_reg, m_shadow);
+	}
+
+	bool valid() const
+	{
+		return m_valid;
+	}
+
+	T shadow() const
+	{
+		return m_shadow;
+	}
+
+	R* get_reg() const
+	{
+		return m_reg;
+	}
+
+protected:
+
+	R* const m_reg;
+
+	T m_shadow;
+	bool m_valid;
+};
+
+template<typename T, typename R>
+struct Register_traits< Shadowed_register<T, R> >
+{
+	typedef T value_type;
+
+	static inline value_type read(Shadowed_register<T, R>* const reg)
+	{
+		return reg->read();
+	}
+
+	static inline void write(Shadowed_register<T, R>* const reg, const value_type val)
+	{
+		reg->write(val);
+	}
+};
+
+template<typename T, typename R>
+struct Register_poll_traits< Shadowed_register<T, R> >
+{
+	static inline T read(Shadowed_register<T, R>* const reg)
+	{
+		reg->sync();
+		return reg->shadow();
+	}
+};
@@ -0,0 +1,223 @@
+/**
+ * @brief Sim_register and Sim_register_bank
+ * @author Jacob Schloss <jacob@schloss.io>
+ * @copyright Copyright (c) 2019 Jacob Schloss. All rights reserved.
+ * @license Licensed under the 3-Clause BSD license. See LICENSE for details
+*/
+
+#pragma once
+
+#include "common_util/Register_util.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+///
+/// A host side stand in for a peripheral register
+/// Counts every read and write made through Register_util or Reg and can script simple device behavior
+///
+template<typename T>
+class Sim_register
+{
+public:
+
+	Sim_register()
+	{
+		m_value = 0;
+		m_w1c_mask = 0;
+
+		m_effect_reads = 0;
+		m_effect_set = 0;
+		m_effect_clear = 0;
+		m_effect_pending = false;
+
+		reset_counts();
+	}
+
+	///
+	/// Bus access, as seen by the driver
+	///
+	T read()
+	{
+		m_reads++;
+
+		if(m_effect_pending)
+		{
+			if(m_effect_reads == 0)
+			{
+				m_value = (m_value & (~m_effect_clear)) | m_effect_set;
+				m_effect_pending = false;
+			}
+			else
+			{
+				m_effect_reads--;
+			}
+		}
+
+		return m_value;
+	}
+
+	void write(const T val)
+	{
+		m_writes++;
+
+		//w1c bits clear when written 1 and hold when written 0, the rest take the written value
+		const T w1c_keep = m_value & m_w1c_mask & (~val);
+		m_value = (val & (~m_w1c_mask)) | w1c_keep;
+	}
+
+	///
+	/// Device side access, not counted
+	///
+	T peek() const
+	{
+		return m_value;
+	}
+
+	void poke(const T val)
+	{
+		m_value = val;
+	}
+
+	///
+	/// Bits in mask are write 1 to clear
+	///
+	void set_w1c_mask(const T mask)
+	{
+		m_w1c_mask = mask;
+	}
+
+	///
+	/// After the next num_reads reads, set and clear bits
+	/// The read after that sees the new value, replaces any effect not yet applied
+	///
+	void schedule_after_reads(const uint32_t num_reads, const T set_mask, const T clear_mask)
+	{
+		m_effect_reads = num_reads;
+		m_effect_set = set_mask;
+		m_effect_clear = clear_mask;
+		m_effect_pending = true;
+	}
+
+	void set_bits_after_reads(const uint32_t num_reads, const T mask)
+	{
+		schedule_after_reads(num_reads, mask, 0);
+	}
+
+	void clear_bits_after_reads(const uint32_t num_reads, const T mask)
+	{
+		schedule_after_reads(num_reads, 0, mask);
+	}
+
+	bool effect_pending() const
+	{
+		return m_effect_pending;
+	}
+
+	uint32_t reads() const
+	{
+		return m_reads;
+	}
+
+	uint32_t writes() const
+	{
+		return m_writes;
+	}
+
+	void reset_counts()
+	{
+		m_reads = 0;
+		m_writes = 0;
+	}
+
+protected:
+
+	T m_value;
+	T m_w1c_mask;
+
+	uint32_t m_effect_reads;
+	T m_effect_set;
+	T m_effect_clear;
+	bool m_effect_pending;
+
+	uint32_t m_reads;
+	uint32_t m_writes;
+};
+
+template<typename T>
+struct Register_traits< Sim_register<T> >
+{
+	typedef T value_type;
+
+	static inline value_type read(Sim_register<T>* const reg)
+	{
+		return reg->read();
+	}
+
+	static inline void write(Sim_register<T>* const reg, const value_type val)
+	{
+		reg->write(val);
+	}
+};
+
+///
+/// N simulated registers, eg one peripheral block
+///
+template<typename T, size_t N>
+class Sim_register_bank
+{
+public:
+
+	Sim_register<T>* get_reg(const size_t idx)
+	{
+		return &m_regs[idx];
+	}
+
+	Sim_register<T>& operator[](const size_t idx)
+	{
+		return m_regs[idx];
+	}
+
+	const Sim_register<T>& operator[](const size_t idx) const
+	{
+		return m_regs[idx];
+	}
+
+	constexpr size_t size() const
+	{
+		return N;
+	}
+
+	uint32_t total_reads() const
+	{
+		uint32_t sum = 0;
+		for(const Sim_register<T>& reg : m_regs)
+		{
+			sum += reg.reads();
+		}
+		return sum;
+	}
+
+	uint32_t total_writes() const
+	{
+		uint32_t sum = 0;
+		for(const Sim_register<T>& reg : m_regs)
+		{
+			sum += reg.writes();
+		}
+		return sum;
+	}
+
+	void reset_counts()
+	{
+		for(Sim_register<T>& reg : m_regs)
+		{
+			reg.reset_counts();
+		}
+	}
+
+protected:
+
+	std::array<Sim_register<T>, N> m_regs;
+};
@@ -0,0 +1,25 @@
+/**
+ * @brief simd_sort
+ * @author Jacob Schloss <jacob@schloss.io>
+ * @copyright Copyright (c) 2019 Jacob Schloss. All rights reserved.
+ * @license Licensed under the 3-Clause BSD license. See LICENSE for details
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+///
+/// Ascending in place sort of primitive keys
+/// Uses an AVX2 quicksort with in register bitonic sorting of small partitions when the cpu has it, intro_sort otherwise
+/// No allocation, not stable
+///
+void simd_sort(int32_t* const data, const size_t n);
+void simd_sort(uint32_t* const data, const size_t n);
+
+///
+/// Floats are ordered by their bits like std::sort with operator<, with -0.0 before +0.0
+/// NaN with the sign bit set sort first and other NaN sort last
+///
+void simd_sort(float* const data, const size_t n);
@@ -0,0 +1,8 @@
+/**
+ * @brief adaptive_sort
+ * @author Jacob Schloss <jacob@schloss.io>
+ * @copyright Copyright (c) 2019 Jacob Schloss. All rights reserved.
+ * @license Licensed under the 3-Clause BSD license. See LICENSE for details
+*/
+
+#include "common_util/Adaptive_sort.hpp"
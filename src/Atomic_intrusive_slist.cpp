@@ -0,0 +1,7 @@
+/**
+ * @author Jacob Schloss <jacob@schloss.io>
+ * @copyright Copyright (c) 2019 Jacob Schloss. All rights reserved.
+ * @license Licensed under the 3-Clause BSD license. See LICENSE for details
+*/
+
+#include "common_util/Atomic_intrusive_slist.hpp"
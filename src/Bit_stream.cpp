@@ -0,0 +1,8 @@
+/**
+ * @brief Bit_reader and Bit_writer
+ * @author Jacob Schloss <jacob@schloss.io>
+ * @copyright Copyright (c) 2019 Jacob Schloss. All rights reserved.
+ * @license Licensed under the 3-Clause BSD license. See LICENSE for details
+*/
+
+#include "common_util/Bit_stream.hpp"
@@ -7,4 +7,402 @@
 
 #include "common_util/Byte_util.hpp"
 
-constexpr char Byte_util::nibble_hex_lut[];
\ No newline at end of file
+#if defined(__x86_64__) || defined(__i386__)
+	#include <immintrin.h>
+	#define BYTE_UTIL_X86 1
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+	#include <arm_neon.h>
+	#define BYTE_UTIL_NEON 1
+#endif
+
+constexpr char Byte_util::nibble_hex_lut[];
+constexpr uint8_t Byte_util::hex_nibble_lut[];
+
+//The SIMD kernels process whole blocks and return how much they consumed
+//The scalar reference finishes the tail, and on decode finds the exact offset of a bad char
+namespace
+{
+#if defined(__SSE2__)
+	inline __m128i nibble_to_hex_sse2(const __m128i n)
+	{
+		const __m128i alpha = _mm_and_si128(_mm_cmpgt_epi8(n, _mm_set1_epi8(9)), _mm_set1_epi8('A' - '0' - 10));
+		return _mm_add_epi8(_mm_add_epi8(n, _mm_set1_epi8('0')), alpha);
+	}
+
+	inline __m128i hex_to_nibble_sse2(const __m128i c, __m128i* const valid)
+	{
+		//chars >= 0x80 are negative and fail both compares
+		//setting bit 5 folds 'A'-'F' onto 'a'-'f'
+		const __m128i lc    = _mm_or_si128(c, _mm_set1_epi8(0x20));
+		const __m128i digit = _mm_and_si128(_mm_cmpgt_epi8(c,  _mm_set1_epi8('0' - 1)), _mm_cmplt_epi8(c,  _mm_set1_epi8('9' + 1)));
+		const __m128i alpha = _mm_and_si128(_mm_cmpgt_epi8(lc, _mm_set1_epi8('a' - 1)), _mm_cmplt_epi8(lc, _mm_set1_epi8('f' + 1)));
+		*valid = _mm_or_si128(digit, alpha);
+
+		//the low nibble of '0'-'9' is the value, 'a'-'f' have 1-6 in the low nibble
+		return _mm_add_epi8(_mm_and_si128(c, _mm_set1_epi8(0x0F)), _mm_and_si128(alpha, _mm_set1_epi8(9)));
+	}
+
+	//16 bit lanes hold {hi, lo} nibble pairs, return (hi << 4) | lo in each lane
+	inline __m128i pack_nibbles_sse2(const __m128i n)
+	{
+		return _mm_or_si128(_mm_slli_epi16(_mm_and_si128(n, _mm_set1_epi16(0x00FF)), 4), _mm_srli_epi16(n, 8));
+	}
+
+	size_t hex_encode_sse2(const uint8_t* const in, const size_t len, char* const out)
+	{
+		size_t i = 0;
+		for(; (i + 16) <= len; i += 16)
+		{
+			const __m128i v  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+			const __m128i hi = nibble_to_hex_sse2(_mm_and_si128(_mm_srli_epi16(v, 4), _mm_set1_epi8(0x0F)));
+			const __m128i lo = nibble_to_hex_sse2(_mm_and_si128(v, _mm_set1_epi8(0x0F)));
+
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(out + 2*i + 0),  _mm_unpacklo_epi8(hi, lo));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(out + 2*i + 16), _mm_unpackhi_epi8(hi, lo));
+		}
+
+		return i;
+	}
+
+	size_t hex_decode_sse2(const char* const in, const size_t len, uint8_t* const out)
+	{
+		size_t i = 0;
+		for(; (i + 32) <= len; i += 32)
+		{
+			__m128i valid_a;
+			__m128i valid_b;
+			const __m128i a = hex_to_nibble_sse2(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i + 0)),  &valid_a);
+			const __m128i b = hex_to_nibble_sse2(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i + 16)), &valid_b);
+
+			if(_mm_movemask_epi8(_mm_and_si128(valid_a, valid_b)) != 0xFFFF)
+			{
+				break;
+			}
+
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(out + i/2), _mm_packus_epi16(pack_nibbles_sse2(a), pack_nibbles_sse2(b)));
+		}
+
+		return i;
+	}
+
+	//SSE2 has no byte shuffle, so swap bytes in each 16 bit lane and then reorder the 16 bit lanes
+	inline __m128i bswap_16_sse2(const __m128i v)
+	{
+		return _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+	}
+
+	inline __m128i bswap_32_sse2(const __m128i v)
+	{
+		const __m128i x = bswap_16_sse2(v);
+		return _mm_shufflehi_epi16(_mm_shufflelo_epi16(x, 0xB1), 0xB1);
+	}
+
+	inline __m128i bswap_64_sse2(const __m128i v)
+	{
+		const __m128i x = bswap_16_sse2(v);
+		return _mm_shufflehi_epi16(_mm_shufflelo_epi16(x, 0x1B), 0x1B);
+	}
+
+	template<typename T, typename Op>
+	size_t bswap_sse2(T* const data, const size_t n, const Op& op)
+	{
+		constexpr size_t STEP = 16 / sizeof(T);
+
+		size_t i = 0;
+		for(; (i + STEP) <= n; i += STEP)
+		{
+			__m128i* const p = reinterpret_cast<__m128i*>(data + i);
+			_mm_storeu_si128(p, op(_mm_loadu_si128(p)));
+		}
+
+		return i;
+	}
+#endif
+
+#if defined(BYTE_UTIL_X86)
+	//shuf is the byte order for one 128 bit lane
+	template<typename T>
+	__attribute__((target("avx2"))) size_t bswap_avx2(T* const data, const size_t n, const uint8_t shuf[16])
+	{
+		constexpr size_t STEP = 32 / sizeof(T);
+
+		const __m256i mask = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(shuf)));
+
+		size_t i = 0;
+		for(; (i + STEP) <= n; i += STEP)
+		{
+			__m256i* const p = reinterpret_cast<__m256i*>(data + i);
+			_mm256_storeu_si256(p, _mm256_shuffle_epi8(_mm256_loadu_si256(p), mask));
+		}
+
+		return i;
+	}
+
+	constexpr uint8_t bswap_16_shuf[16] = {1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14};
+	constexpr uint8_t bswap_32_shuf[16] = {3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12};
+	constexpr uint8_t bswap_64_shuf[16] = {7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8};
+
+	__attribute__((target("avx2"))) inline __m256i nibble_to_hex_avx2(const __m256i n)
+	{
+		const __m256i alpha = _mm256_and_si256(_mm256_cmpgt_epi8(n, _mm256_set1_epi8(9)), _mm256_set1_epi8('A' - '0' - 10));
+		return _mm256_add_epi8(_mm256_add_epi8(n, _mm256_set1_epi8('0')), alpha);
+	}
+
+	__attribute__((target("avx2"))) inline __m256i hex_to_nibble_avx2(const __m256i c, __m256i* const valid)
+	{
+		const __m256i lc    = _mm256_or_si256(c, _mm256_set1_epi8(0x20));
+		const __m256i digit = _mm256_and_si256(_mm256_cmpgt_epi8(c,  _mm256_set1_epi8('0' - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8('9' + 1), c));
+		const __m256i alpha = _mm256_and_si256(_mm256_cmpgt_epi8(lc, _mm256_set1_epi8('a' - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8('f' + 1), lc));
+		*valid = _mm256_or_si256(digit, alpha);
+
+		return _mm256_add_epi8(_mm256_and_si256(c, _mm256_set1_epi8(0x0F)), _mm256_and_si256(alpha, _mm256_set1_epi8(9)));
+	}
+
+	__attribute__((target("avx2"))) inline __m256i pack_nibbles_avx2(const __m256i n)
+	{
+		return _mm256_or_si256(_mm256_slli_epi16(_mm256_and_si256(n, _mm256_set1_epi16(0x00FF)), 4), _mm256_srli_epi16(n, 8));
+	}
+
+	__attribute__((target("avx2"))) size_t hex_encode_avx2(const uint8_t* const in, const size_t len, char* const out)
+	{
+		size_t i = 0;
+		for(; (i + 32) <= len; i += 32)
+		{
+			const __m256i v  = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+			const __m256i hi = nibble_to_hex_avx2(_mm256_and_si256(_mm256_srli_epi16(v, 4), _mm256_set1_epi8(0x0F)));
+			const __m256i lo = nibble_to_hex_avx2(_mm256_and_si256(v, _mm256_set1_epi8(0x0F)));
+
+			//unpack works within 128 bit lanes, so fix up the order with a cross lane permute
+			const __m256i a = _mm256_unpacklo_epi8(hi, lo);
+			const __m256i b = _mm256_unpackhi_epi8(hi, lo);
+
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(out + 2*i + 0),  _mm256_permute2x128_si256(a, b, 0x20));
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(out + 2*i + 32), _mm256_permute2x128_si256(a, b, 0x31));
+		}
+
+		return i;
+	}
+
+	__attribute__((target("avx2"))) size_t hex_decode_avx2(const char* const in, const size_t len, uint8_t* const out)
+	{
+		size_t i = 0;
+		for(; (i + 64) <= len; i += 64)
+		{
+			__m256i valid_a;
+			__m256i valid_b;
+			const __m256i a = hex_to_nibble_avx2(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i + 0)),  &valid_a);
+			const __m256i b = hex_to_nibble_avx2(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i + 32)), &valid_b);
+
+			if(_mm256_movemask_epi8(_mm256_and_si256(valid_a, valid_b)) != -1)
+			{
+				break;
+			}
+
+			//pack works within 128 bit lanes, restore the order of the 64 bit halves
+			const __m256i packed = _mm256_packus_epi16(pack_nibbles_avx2(a), pack_nibbles_avx2(b));
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i/2), _mm256_permute4x64_epi64(packed, 0xD8));
+		}
+
+		return i;
+	}
+
+	bool cpu_has_avx2()
+	{
+		static const bool has_avx2 = __builtin_cpu_supports("avx2");
+		return has_avx2;
+	}
+#endif
+
+#if defined(BYTE_UTIL_NEON)
+	inline uint8x16_t nibble_to_hex_neon(const uint8x16_t n)
+	{
+		const uint8x16_t alpha = vandq_u8(vcgtq_u8(n, vdupq_n_u8(9)), vdupq_n_u8('A' - '0' - 10));
+		return vaddq_u8(vaddq_u8(n, vdupq_n_u8('0')), alpha);
+	}
+
+	inline uint8x16_t hex_to_nibble_neon(const uint8x16_t c, uint8x16_t* const valid)
+	{
+		const uint8x16_t lc    = vorrq_u8(c, vdupq_n_u8(0x20));
+		const uint8x16_t digit = vandq_u8(vcgeq_u8(c,  vdupq_n_u8('0')), vcleq_u8(c,  vdupq_n_u8('9')));
+		const uint8x16_t alpha = vandq_u8(vcgeq_u8(lc, vdupq_n_u8('a')), vcleq_u8(lc, vdupq_n_u8('f')));
+		*valid = vorrq_u8(digit, alpha);
+
+		return vaddq_u8(vandq_u8(c, vdupq_n_u8(0x0F)), vandq_u8(alpha, vdupq_n_u8(9)));
+	}
+
+	size_t hex_encode_neon(const uint8_t* const in, const size_t len, char* const out)
+	{
+		size_t i = 0;
+		for(; (i + 16) <= len; i += 16)
+		{
+			const uint8x16_t v = vld1q_u8(in + i);
+
+			uint8x16x2_t hex;
+			hex.val[0] = nibble_to_hex_neon(vshrq_n_u8(v, 4));
+			hex.val[1] = nibble_to_hex_neon(vandq_u8(v, vdupq_n_u8(0x0F)));
+
+			vst2q_u8(reinterpret_cast<uint8_t*>(out + 2*i), hex);
+		}
+
+		return i;
+	}
+
+	size_t hex_decode_neon(const char* const in, const size_t len, uint8_t* const out)
+	{
+		size_t i = 0;
+		for(; (i + 32) <= len; i += 32)
+		{
+			//de-interleave into the hi and lo nibble chars
+			const uint8x16x2_t c = vld2q_u8(reinterpret_cast<const uint8_t*>(in + i));
+
+			uint8x16_t valid_hi;
+			uint8x16_t valid_lo;
+			const uint8x16_t hi = hex_to_nibble_neon(c.val[0], &valid_hi);
+			const uint8x16_t lo = hex_to_nibble_neon(c.val[1], &valid_lo);
+
+			if(vminvq_u8(vandq_u8(valid_hi, valid_lo)) != 0xFF)
+			{
+				break;
+			}
+
+			vst1q_u8(out + i/2, vorrq_u8(vshlq_n_u8(hi, 4), lo));
+		}
+
+		return i;
+	}
+
+	template<typename T, typename Op>
+	size_t bswap_neon(T* const data, const size_t n, const Op& op)
+	{
+		constexpr size_t STEP = 16 / sizeof(T);
+
+		size_t i = 0;
+		for(; (i + STEP) <= n; i += STEP)
+		{
+			uint8_t* const p = reinterpret_cast<uint8_t*>(data + i);
+			vst1q_u8(p, op(vld1q_u8(p)));
+		}
+
+		return i;
+	}
+#endif
+}
+
+void Byte_util::hex_encode(const uint8_t* const in, const size_t len, char* const out)
+{
+	size_t n = 0;
+
+#if defined(BYTE_UTIL_X86)
+	if(cpu_has_avx2())
+	{
+		n = hex_encode_avx2(in, len, out);
+	}
+#endif
+
+#if defined(__SSE2__)
+	n += hex_encode_sse2(in + n, len - n, out + 2*n);
+#elif defined(BYTE_UTIL_NEON)
+	n += hex_encode_neon(in + n, len - n, out + 2*n);
+#endif
+
+	hex_encode_scalar(in + n, len - n, out + 2*n);
+}
+
+bool Byte_util::hex_decode(const char* const in, const size_t len, uint8_t* const out, size_t* const err_idx)
+{
+	size_t n = 0;
+
+#if defined(BYTE_UTIL_X86)
+	if(cpu_has_avx2())
+	{
+		n = hex_decode_avx2(in, len, out);
+	}
+#endif
+
+#if defined(__SSE2__)
+	n += hex_decode_sse2(in + n, len - n, out + n/2);
+#elif defined(BYTE_UTIL_NEON)
+	n += hex_decode_neon(in + n, len - n, out + n/2);
+#endif
+
+	size_t tail_err_idx = 0;
+	if(!hex_decode_scalar(in + n, len - n, out + n/2, &tail_err_idx))
+	{
+		if(err_idx)
+		{
+			*err_idx = n + tail_err_idx;
+		}
+		return false;
+	}
+
+	return true;
+}
+
+void Byte_util::bswap_n(uint16_t* const data, const size_t n)
+{
+	size_t i = 0;
+
+#if defined(BYTE_UTIL_X86)
+	if(cpu_has_avx2())
+	{
+		i = bswap_avx2(data, n, bswap_16_shuf);
+	}
+#endif
+
+#if defined(__SSE2__)
+	i += bswap_sse2(data + i, n - i, bswap_16_sse2);
+#elif defined(BYTE_UTIL_NEON)
+	i += bswap_neon(data + i, n - i, [](const uint8x16_t v){ return vrev16q_u8(v); });
+#endif
+
+	for(; i < n; i++)
+	{
+		data[i] = bswap_16(data[i]);
+	}
+}
+
+void Byte_util::bswap_n(uint32_t* const data, const size_t n)
+{
+	size_t i = 0;
+
+#if defined(BYTE_UTIL_X86)
+	if(cpu_has_avx2())
+	{
+		i = bswap_avx2(data, n, bswap_32_shuf);
+	}
+#endif
+
+#if defined(__SSE2__)
+	i += bswap_sse2(data + i, n - i, bswap_32_sse2);
+#elif defined(BYTE_UTIL_NEON)
+	i += bswap_neon(data + i, n - i, [](const uint8x16_t v){ return vrev32q_u8(v); });
+#endif
+
+	for(; i < n; i++)
+	{
+		data[i] = bswap_32(data[i]);
+	}
+}
+
+void Byte_util::bswap_n(uint64_t* const data, const size_t n)
+{
+	size_t i = 0;
+
+#if defined(BYTE_UTIL_X86)
+	if(cpu_has_avx2())
+	{
+		i = bswap_avx2(data, n, bswap_64_shuf);
+	}
+#endif
+
+#if defined(__SSE2__)
+	i += bswap_sse2(data + i, n - i, bswap_64_sse2);
+#elif defined(BYTE_UTIL_NEON)
+	i += bswap_neon(data + i, n - i, [](const uint8x16_t v){ return vrev64q_u8(v); });
+#endif
+
+	for(; i < n; i++)
+	{
+		data[i] = bswap_64(data[i]);
+	}
+}
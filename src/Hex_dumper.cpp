@@ -0,0 +1,214 @@
+/**
+ * @brief Hex_dumper
+ * @author Jacob Schloss <jacob@schloss.io>
+ * @copyright Copyright (c) 2019 Jacob Schloss. All rights reserved.
+ * @license Licensed under the 3-Clause BSD license. See LICENSE for details
+*/
+
+#include "common_util/Hex_dumper.hpp"
+
+#include "common_util/Byte_util.hpp"
+
+#include <algorithm>
+
+constexpr size_t Hex_dumper::MAX_WIDTH;
+constexpr size_t Hex_dumper::MAX_OFFSET_DIGITS;
+constexpr size_t Hex_dumper::MAX_LINE_LEN;
+
+size_t Hex_dumper::line_len() const
+{
+	size_t len = 0;
+
+	if(m_offset_digits != 0)
+	{
+		len += m_offset_digits + 2;
+	}
+
+	len += m_width * 2;
+
+	if(m_group != 0)
+	{
+		len += (m_width - 1) / m_group;
+	}
+
+	if(m_show_ascii)
+	{
+		len += 2 + m_width;
+	}
+
+	return len + 1;
+}
+
+size_t Hex_dumper::write(const uint8_t* const in, const size_t len, char* const out, const size_t out_len, size_t* const out_written)
+{
+	const size_t max_line = line_len();
+
+	size_t consumed = 0;
+	size_t written = 0;
+
+	for(;;)
+	{
+		if(m_line_fill == m_width)
+		{
+			if((out_len - written) < max_line)
+			{
+				break;
+			}
+
+			written += format_line(m_line.data(), m_line_fill, out + written);
+			m_offset += m_width;
+			m_line_fill = 0;
+		}
+		else if(consumed == len)
+		{
+			break;
+		}
+		else if((m_line_fill == 0) && ((len - consumed) >= m_width))
+		{
+			//whole line available, format straight from the input
+			if((out_len - written) < max_line)
+			{
+				break;
+			}
+
+			written += format_line(in + consumed, m_width, out + written);
+			m_offset += m_width;
+			consumed += m_width;
+		}
+		else
+		{
+			const size_t num_to_copy = std::min(m_width - m_line_fill, len - consumed);
+
+			std::copy_n(in + consumed, num_to_copy, m_line.data() + m_line_fill);
+			m_line_fill += num_to_copy;
+			consumed += num_to_copy;
+		}
+	}
+
+	if(out_written)
+	{
+		*out_written = written;
+	}
+
+	return consumed;
+}
+
+size_t Hex_dumper::write(const uint8_t* const in, const size_t len, Stack_string_base* const str)
+{
+	std::array<char, MAX_LINE_LEN> line;
+
+	size_t consumed = 0;
+	for(;;)
+	{
+		size_t written = 0;
+		consumed += write(in + consumed, len - consumed, line.data(), std::min(line.size(), str->free_space()), &written);
+
+		if(written == 0)
+		{
+			break;
+		}
+
+		str->append(line.data(), line.data() + written);
+	}
+
+	return consumed;
+}
+
+bool Hex_dumper::flush(char* const out, const size_t out_len, size_t* const out_written)
+{
+	size_t written = 0;
+
+	if(m_line_fill != 0)
+	{
+		//the ascii gutter of a partial line is not padded
+		const size_t partial_len = m_show_ascii ? (line_len() - (m_width - m_line_fill)) : line_len();
+		if(out_len < partial_len)
+		{
+			return false;
+		}
+
+		written = format_line(m_line.data(), m_line_fill, out);
+		m_offset += m_line_fill;
+		m_line_fill = 0;
+	}
+
+	if(out_written)
+	{
+		*out_written = written;
+	}
+
+	return true;
+}
+
+bool Hex_dumper::flush(Stack_string_base* const str)
+{
+	std::array<char, MAX_LINE_LEN> line;
+
+	size_t written = 0;
+	if(!flush(line.data(), std::min(line.size(), str->free_space()), &written))
+	{
+		return false;
+	}
+
+	str->append(line.data(), line.data() + written);
+
+	return true;
+}
+
+size_t Hex_dumper::format_line(const uint8_t* const data, const size_t len, char* const out) const
+{
+	char* p = out;
+
+	if(m_offset_digits == 16)
+	{
+		Byte_util::u64_to_hex(m_offset, p);
+		p += 16;
+		*p++ = ':';
+		*p++ = ' ';
+	}
+	else if(m_offset_digits == 8)
+	{
+		Byte_util::u32_to_hex(uint32_t(m_offset), p);
+		p += 8;
+		*p++ = ':';
+		*p++ = ' ';
+	}
+
+	size_t group_fill = 0;
+	for(size_t i = 0; i < m_width; i++)
+	{
+		if(i < len)
+		{
+			Byte_util::u8_to_hex(data[i], p);
+		}
+		else
+		{
+			p[0] = ' ';
+			p[1] = ' ';
+		}
+		p += 2;
+
+		group_fill++;
+		if((group_fill == m_group) && ((i + 1) != m_width))
+		{
+			*p++ = ' ';
+			group_fill = 0;
+		}
+	}
+
+	if(m_show_ascii)
+	{
+		*p++ = ' ';
+		*p++ = ' ';
+
+		for(size_t i = 0; i < len; i++)
+		{
+			const uint8_t c = data[i];
+			*p++ = ((c >= 0x20) && (c < 0x7F)) ? char(c) : '.';
+		}
+	}
+
+	*p++ = '\n';
+
+	return p - out;
+}
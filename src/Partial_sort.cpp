@@ -0,0 +1,8 @@
+/**
+ * @brief partial_insertion_sort, partial_heap_sort, intro_select and Top_k
+ * @author Jacob Schloss <jacob@schloss.io>
+ * @copyright Copyright (c) 2019 Jacob Schloss. All rights reserved.
+ * @license Licensed under the 3-Clause BSD license. See LICENSE for details
+*/
+
+#include "common_util/Partial_sort.hpp"
@@ -0,0 +1,89 @@
+/**
+ * @brief Register_trace_buffer
+ * @author Jacob Schloss <jacob@schloss.io>
+ * @copyright Copyright (c) 2019 Jacob Schloss. All rights reserved.
+ * @license Licensed under the 3-Clause BSD license. See LICENSE for details
+*/
+
+#include "common_util/Register_trace.hpp"
+
+#include "common_util/Byte_util.hpp"
+#include "common_util/Stack_string_base.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+constexpr size_t Register_trace_decoder::MAX_LINE_LEN;
+
+const char* Register_trace_decoder::op_name(const Register_op op)
+{
+	switch(op)
+	{
+		case Register_op::MASK_SET_BITS:
+			return "MASK_SET_BITS";
+		case Register_op::SET_BITS:
+			return "SET_BITS";
+		case Register_op::CLEAR_BITS:
+			return "CLEAR_BITS";
+		case Register_op::WAIT_SET:
+			return "WAIT_SET";
+		case Register_op::WAIT_CLEAR:
+			return "WAIT_CLEAR";
+		case Register_op::WAIT_VALUE:
+			return "WAIT_VALUE";
+		case Register_op::WAIT_TIMEOUT:
+			return "WAIT_TIMEOUT";
+		default:
+			break;
+	}
+
+	return "UNKNOWN";
+}
+
+bool Register_trace_decoder::format(const Register_trace_record& rec, Stack_string_base* const str)
+{
+	//Stack_string_base::append runs strlen over its input, so the line needs a terminator
+	std::array<char, MAX_LINE_LEN + 1> line;
+	char* p = line.data();
+
+	Byte_util::u32_to_hex(rec.seq, p);
+	p += 8;
+	*p++ = ' ';
+
+	Byte_util::u32_to_hex(rec.timestamp, p);
+	p += 8;
+	*p++ = ' ';
+
+	const char* name = op_name(rec.op);
+	const size_t name_len = strlen(name);
+	std::copy_n(name, name_len, p);
+	p += name_len;
+	*p++ = ' ';
+
+	Byte_util::u64_to_hex(uint64_t(rec.addr), p);
+	p += 16;
+	*p++ = ' ';
+
+	Byte_util::u64_to_hex(rec.old_val, p);
+	p += 16;
+	*p++ = ' ';
+	*p++ = '-';
+	*p++ = '>';
+	*p++ = ' ';
+
+	Byte_util::u64_to_hex(rec.new_val, p);
+	p += 16;
+	*p++ = '\n';
+	*p = '\0';
+
+	const size_t len = p - line.data();
+	if(str->free_space() < len)
+	{
+		return false;
+	}
+
+	str->append(line.data(), len);
+
+	return true;
+}
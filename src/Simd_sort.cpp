@@ -0,0 +1,344 @@
+/**
+ * @brief simd_sort
+ * @author Jacob Schloss <jacob@schloss.io>
+ * @copyright Copyright (c) 2019 Jacob Schloss. All rights reserved.
+ * @license Licensed under the 3-Clause BSD license. See LICENSE for details
+*/
+
+#include "common_util/Simd_sort.hpp"
+
+#include "common_util/Intro_sort.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <limits>
+
+#if defined(__x86_64__) || defined(__i386__)
+	#include <immintrin.h>
+	#define SIMD_SORT_X86 1
+#endif
+
+//u32 and float keys are mapped in place to i32 with the same order, sorted, then mapped back
+namespace
+{
+	//the buffers passed in are not i32 objects
+	typedef int32_t __attribute__((may_alias)) i32_alias;
+	typedef uint32_t __attribute__((may_alias)) u32_alias;
+
+	void map_u32(u32_alias* const data, const size_t n)
+	{
+		for(size_t i = 0; i < n; i++)
+		{
+			data[i] ^= 0x80000000U;
+		}
+	}
+
+	//flips the magnitude of negative floats so they order as signed ints, applying it twice is the identity
+	void map_float(u32_alias* const data, const size_t n)
+	{
+		for(size_t i = 0; i < n; i++)
+		{
+			const uint32_t x = data[i];
+			data[i] = x ^ (uint32_t(int32_t(x) >> 31) & 0x7FFFFFFFU);
+		}
+	}
+
+	void sort_i32_scalar(i32_alias* const data, const size_t n)
+	{
+		intro_sort(data, data + n, std::less<int32_t>());
+	}
+
+#if defined(SIMD_SORT_X86)
+
+	//partitions at or below this size are sorted in registers
+	constexpr size_t AVX2_SMALL_SORT = 16;
+
+	//lane i takes max if bit set
+	template<int IMM_SHUF, int IMM_BLEND>
+	__attribute__((target("avx2"))) inline __m256i cmp_exchange_shuffle(const __m256i v)
+	{
+		const __m256i p = _mm256_shuffle_epi32(v, IMM_SHUF);
+		return _mm256_blend_epi32(_mm256_min_epi32(v, p), _mm256_max_epi32(v, p), IMM_BLEND);
+	}
+
+	__attribute__((target("avx2"))) inline __m256i reverse8(const __m256i v)
+	{
+		return _mm256_permutevar8x32_epi32(v, _mm256_setr_epi32(7, 6, 5, 4, 3, 2, 1, 0));
+	}
+
+	//finish a bitonic merge of 8 lanes, compare i with i^4, i^2, i^1
+	__attribute__((target("avx2"))) inline __m256i bitonic_clean8(__m256i v)
+	{
+		const __m256i p = _mm256_permute2x128_si256(v, v, 0x01);
+		v = _mm256_blend_epi32(_mm256_min_epi32(v, p), _mm256_max_epi32(v, p), 0xF0);
+		v = cmp_exchange_shuffle<_MM_SHUFFLE(1, 0, 3, 2), 0xCC>(v);
+		v = cmp_exchange_shuffle<_MM_SHUFFLE(2, 3, 0, 1), 0xAA>(v);
+		return v;
+	}
+
+	__attribute__((target("avx2"))) inline __m256i bitonic_sort8(__m256i v)
+	{
+		//blocks of 2
+		v = cmp_exchange_shuffle<_MM_SHUFFLE(2, 3, 0, 1), 0xAA>(v);
+
+		//blocks of 4, compare i with i^3 then i^1
+		v = cmp_exchange_shuffle<_MM_SHUFFLE(0, 1, 2, 3), 0xCC>(v);
+		v = cmp_exchange_shuffle<_MM_SHUFFLE(2, 3, 0, 1), 0xAA>(v);
+
+		//blocks of 8, compare i with i^7 then clean
+		const __m256i r = reverse8(v);
+		v = _mm256_blend_epi32(_mm256_min_epi32(v, r), _mm256_max_epi32(v, r), 0xF0);
+		v = cmp_exchange_shuffle<_MM_SHUFFLE(1, 0, 3, 2), 0xCC>(v);
+		v = cmp_exchange_shuffle<_MM_SHUFFLE(2, 3, 0, 1), 0xAA>(v);
+
+		return v;
+	}
+
+	__attribute__((target("avx2"))) inline void bitonic_sort16(__m256i* const a, __m256i* const b)
+	{
+		const __m256i sa = bitonic_sort8(*a);
+		const __m256i rb = reverse8(bitonic_sort8(*b));
+
+		//compare i with 15-i, then clean each half
+		*a = bitonic_clean8(_mm256_min_epi32(sa, rb));
+		*b = bitonic_clean8(reverse8(_mm256_max_epi32(sa, rb)));
+	}
+
+	__attribute__((target("avx2"))) void small_sort_avx2(i32_alias* const data, const size_t n)
+	{
+		alignas(32) int32_t buf[16];
+		std::fill_n(buf, 16, std::numeric_limits<int32_t>::max());
+		std::copy_n(data, n, buf);
+
+		__m256i a = _mm256_load_si256(reinterpret_cast<const __m256i*>(buf + 0));
+		__m256i b = _mm256_load_si256(reinterpret_cast<const __m256i*>(buf + 8));
+		bitonic_sort16(&a, &b);
+		_mm256_store_si256(reinterpret_cast<__m256i*>(buf + 0), a);
+		_mm256_store_si256(reinterpret_cast<__m256i*>(buf + 8), b);
+
+		std::copy_n(buf, n, data);
+	}
+
+	//for each 8 bit mask of lanes going right, lane indices that put the left lanes first, each in order
+	struct Partition_lut
+	{
+		Partition_lut()
+		{
+			for(uint32_t mask = 0; mask < 256; mask++)
+			{
+				uint32_t pos = 0;
+				for(uint32_t i = 0; i < 8; i++)
+				{
+					if(((mask >> i) & 1U) == 0)
+					{
+						idx[mask][pos++] = i;
+					}
+				}
+				for(uint32_t i = 0; i < 8; i++)
+				{
+					if(((mask >> i) & 1U) != 0)
+					{
+						idx[mask][pos++] = i;
+					}
+				}
+			}
+		}
+
+		alignas(32) int32_t idx[256][8];
+	};
+
+	const Partition_lut& get_partition_lut()
+	{
+		static const Partition_lut lut;
+		return lut;
+	}
+
+	//GE_RIGHT false: x > pivot goes right, true: x >= pivot goes right
+	template<bool GE_RIGHT>
+	inline bool goes_right(const int32_t x, const int32_t pivot)
+	{
+		return GE_RIGHT ? (x >= pivot) : (x > pivot);
+	}
+
+	template<bool GE_RIGHT>
+	__attribute__((target("avx2"))) inline uint32_t right_mask_avx2(const __m256i v, const __m256i pv)
+	{
+		if(GE_RIGHT)
+		{
+			return (~uint32_t(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(pv, v))))) & 0xFFU;
+		}
+
+		return uint32_t(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(v, pv))));
+	}
+
+	///
+	/// Partition n >= 16 elements, returns the split
+	/// Reads 8 at a time from whichever end has less free space, and stores the compressed vector to both ends
+	/// The first and last 8 are held aside to make the initial space
+	///
+	template<bool GE_RIGHT>
+	__attribute__((target("avx2"))) size_t partition_avx2(i32_alias* const data, const size_t n, const int32_t pivot, const Partition_lut& lut)
+	{
+		const __m256i pv = _mm256_set1_epi32(pivot);
+
+		alignas(32) int32_t held[16 + 8];
+		_mm256_store_si256(reinterpret_cast<__m256i*>(held + 0), _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data)));
+		_mm256_store_si256(reinterpret_cast<__m256i*>(held + 8), _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + n - 8)));
+
+		size_t read_l = 8;
+		size_t read_r = n - 8;
+		size_t write_l = 0;
+		size_t write_r = n;
+
+		while((read_r - read_l) >= 8)
+		{
+			__m256i v;
+			if((read_l - write_l) <= (write_r - read_r))
+			{
+				v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + read_l));
+				read_l += 8;
+			}
+			else
+			{
+				read_r -= 8;
+				v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + read_r));
+			}
+
+			const uint32_t mask = right_mask_avx2<GE_RIGHT>(v, pv);
+			const uint32_t num_right = uint32_t(__builtin_popcount(mask));
+
+			const __m256i perm = _mm256_load_si256(reinterpret_cast<const __m256i*>(lut.idx[mask]));
+			const __m256i out = _mm256_permutevar8x32_epi32(v, perm);
+
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(data + write_l), out);
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(data + write_r - 8), out);
+
+			write_l += 8 - num_right;
+			write_r -= num_right;
+		}
+
+		//fewer than 8 left unread, hold them aside too and place everything held one at a time
+		const size_t num_tail = read_r - read_l;
+		std::copy_n(data + read_l, num_tail, held + 16);
+
+		for(size_t i = 0; i < (16 + num_tail); i++)
+		{
+			const int32_t x = held[i];
+			if(goes_right<GE_RIGHT>(x, pivot))
+			{
+				write_r--;
+				data[write_r] = x;
+			}
+			else
+			{
+				data[write_l] = x;
+				write_l++;
+			}
+		}
+
+		return write_l;
+	}
+
+	int32_t median_of_3(const int32_t a, const int32_t b, const int32_t c)
+	{
+		return std::max(std::min(a, b), std::min(std::max(a, b), c));
+	}
+
+	__attribute__((target("avx2"))) void quicksort_avx2(i32_alias* data, size_t n, size_t depth_limit, const Partition_lut& lut)
+	{
+		while(n > AVX2_SMALL_SORT)
+		{
+			if(depth_limit == 0)
+			{
+				heap_sort(data, data + n, std::less<int32_t>());
+				return;
+			}
+			depth_limit--;
+
+			//median of 3 medians of 3
+			const size_t s = n / 8;
+			const int32_t pivot = median_of_3(
+				median_of_3(data[0],         data[s],         data[2 * s]),
+				median_of_3(data[3 * s],     data[n / 2],     data[5 * s]),
+				median_of_3(data[6 * s],     data[7 * s],     data[n - 1])
+			);
+
+			size_t split = partition_avx2<false>(data, n, pivot, lut);
+			if(split == n)
+			{
+				//nothing above the pivot, split off everything equal to it instead
+				split = partition_avx2<true>(data, n, pivot, lut);
+				n = split;
+				continue;
+			}
+
+			//recurse into the smaller side
+			if(split < (n - split))
+			{
+				quicksort_avx2(data, split, depth_limit, lut);
+				data += split;
+				n -= split;
+			}
+			else
+			{
+				quicksort_avx2(data + split, n - split, depth_limit, lut);
+				n = split;
+			}
+		}
+
+		if(n > 1)
+		{
+			small_sort_avx2(data, n);
+		}
+	}
+
+	bool cpu_has_avx2()
+	{
+		static const bool has_avx2 = __builtin_cpu_supports("avx2");
+		return has_avx2;
+	}
+#endif
+
+	void sort_i32(i32_alias* const data, const size_t n)
+	{
+#if defined(SIMD_SORT_X86)
+		if(cpu_has_avx2())
+		{
+			size_t depth_limit = 0;
+			for(size_t k = n; k > 1; k >>= 1)
+			{
+				depth_limit += 2;
+			}
+
+			quicksort_avx2(data, n, depth_limit, get_partition_lut());
+			return;
+		}
+#endif
+
+		sort_i32_scalar(data, n);
+	}
+}
+
+void simd_sort(int32_t* const data, const size_t n)
+{
+	sort_i32(data, n);
+}
+
+void simd_sort(uint32_t* const data, const size_t n)
+{
+	u32_alias* const u = data;
+
+	map_u32(u, n);
+	sort_i32(reinterpret_cast<i32_alias*>(u), n);
+	map_u32(u, n);
+}
+
+void simd_sort(float* const data, const size_t n)
+{
+	u32_alias* const u = reinterpret_cast<u32_alias*>(data);
+
+	map_float(u, n);
+	sort_i32(reinterpret_cast<i32_alias*>(u), n);
+	map_float(u, n);
+}
@@ -1,7 +1,9 @@
 #include "common_util/Byte_util.hpp"
 
 #include "gtest/gtest.h"
+#include "gmock/gmock.h"
 
+#include <algorithm>
 #include <array>
 #include <vector>
 
@@ -9,6 +11,32 @@ namespace
 {
 	constexpr std::array<char, 16> hex_digit_map = {'0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'A', 'B', 'C', 'D', 'E', 'F'};
 
+	constexpr uint16_t constexpr_hex_to_u16(const char c[4])
+	{
+		uint16_t n = 0;
+		return Byte_util::hex_to_u16(c, &n) ? n : 0;
+	}
+
+	static_assert(constexpr_hex_to_u16("beEF") == 0xBEEF);
+	static_assert(constexpr_hex_to_u16("bxEF") == 0);
+
+	constexpr uint64_t constexpr_hex_str_to_u64(const std::array<char, 17>& str)
+	{
+		uint64_t n = 0;
+		return Byte_util::hex_str_to_u64(str, &n) ? n : 0;
+	}
+
+	constexpr uint32_t constexpr_be_round_trip(const uint32_t x)
+	{
+		uint8_t buf[4] = {0, 0, 0, 0};
+		Byte_util::store_be<uint32_t>(buf, x);
+		return Byte_util::load_le<uint32_t>(buf);
+	}
+
+	static_assert(constexpr_be_round_trip(0x01234567) == 0x67452301);
+
+	static_assert(constexpr_hex_str_to_u64({'F', 'e', 'd', 'C', 'b', 'A', '9', '8', '7', '6', '5', '4', '3', '2', '1', '0', '\0'}) == 0xFEDCBA9876543210ULL);
+
 	TEST(Byte_util, hex_to_nibble_pass_domain)
 	{
 		const std::array<uint8_t, 16> expected_output = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15};
@@ -45,13 +73,74 @@ namespace
 			in = i;
 			EXPECT_TRUE(Byte_util::hex_to_nibble(in, &out));
 		}
-		for(size_t i = 'G'; i < 128; i++)
+		for(size_t i = 'G'; i < 'a'; i++)
+		{
+			in = i;
+			EXPECT_FALSE(Byte_util::hex_to_nibble(in, &out));
+		}
+		for(size_t i = 'a'; i < 'g'; i++)
+		{
+			in = i;
+			EXPECT_TRUE(Byte_util::hex_to_nibble(in, &out));
+		}
+		for(size_t i = 'g'; i < 256; i++)
 		{
 			in = i;
 			EXPECT_FALSE(Byte_util::hex_to_nibble(in, &out));
 		}
 	}
 
+	TEST(Byte_util, hex_to_nibble_lowercase)
+	{
+		const std::array<char, 6> input = {'a', 'b', 'c', 'd', 'e', 'f'};
+
+		for(size_t i = 0; i < input.size(); i++)
+		{
+			uint8_t out = 0;
+			EXPECT_TRUE(Byte_util::hex_to_nibble(input[i], &out));
+			EXPECT_EQ(out, 10 + i);
+		}
+	}
+
+	TEST(Byte_util, hex_to_byte_invalid)
+	{
+		uint8_t out = 0x5A;
+
+		EXPECT_FALSE(Byte_util::hex_to_byte("G0", &out));
+		EXPECT_FALSE(Byte_util::hex_to_byte("0G", &out));
+		EXPECT_FALSE(Byte_util::hex_to_byte("\xB0""0", &out));
+		EXPECT_EQ(out, 0x5A);
+
+		EXPECT_TRUE(Byte_util::hex_to_byte("aF", &out));
+		EXPECT_EQ(out, 0xAF);
+	}
+
+	TEST(Byte_util, hex_str_to_uT)
+	{
+		uint16_t u16 = 0;
+		EXPECT_TRUE(Byte_util::hex_str_to_u16({'b', 'E', 'e', 'F', '\0'}, &u16));
+		EXPECT_EQ(u16, 0xBEEF);
+
+		uint32_t u32 = 0;
+		EXPECT_TRUE(Byte_util::hex_str_to_u32({'d', 'e', 'a', 'd', 'B', 'E', 'E', 'F', '\0'}, &u32));
+		EXPECT_EQ(u32, 0xDEADBEEF);
+
+		uint64_t u64 = 0;
+		EXPECT_TRUE(Byte_util::hex_str_to_u64({'0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'a', 'b', 'C', 'D', 'e', 'f', '\0'}, &u64));
+		EXPECT_EQ(u64, 0x0123456789ABCDEFULL);
+
+		//any single bad char fails the whole field and leaves the output alone
+		for(size_t i = 0; i < 16; i++)
+		{
+			std::array<char, 17> str = {'0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'a', 'b', 'C', 'D', 'e', 'f', '\0'};
+			str[i] = 'x';
+
+			u64 = 0;
+			EXPECT_FALSE(Byte_util::hex_str_to_u64(str, &u64));
+			EXPECT_EQ(u64, 0);
+		}
+	}
+
 	TEST(Byte_util, hex_to_byte_domain)
 	{
 		for(size_t i = 0; i < 16; i++)
@@ -68,6 +157,184 @@ namespace
 		}
 	}
 
+	TEST(Byte_util, hex_str_to_u32_swar_matches_lut)
+	{
+		const std::array<char, 9> base = {'0', 'a', '1', 'B', '2', 'c', '9', 'F', '\0'};
+
+		//every byte value at every position, checked against the table driven reference
+		for(size_t pos = 0; pos < 8; pos++)
+		{
+			for(size_t c = 0; c < 256; c++)
+			{
+				std::array<char, 9> str = base;
+				str[pos] = char(c);
+
+				uint32_t expected = 0;
+				const bool expected_ret = Byte_util::hex_str_to_uT<uint32_t>(str, &expected);
+
+				uint32_t output = 0;
+				ASSERT_EQ(Byte_util::hex_str_to_u32(str, &output), expected_ret);
+				ASSERT_EQ(output, expected);
+			}
+		}
+	}
+
+	TEST(Byte_util, hex_str_to_u64_swar_matches_lut)
+	{
+		std::array<char, 17> str;
+		str.back() = '\0';
+
+		uint32_t seed = 1;
+		for(size_t i = 0; i < 10000; i++)
+		{
+			for(size_t j = 0; j < 16; j++)
+			{
+				seed = seed * 1103515245U + 12345U;
+				const uint8_t r = seed >> 16;
+
+				//mostly valid hex in both cases, with the odd bad char
+				if(r < 8)
+				{
+					str[j] = char(seed >> 24);
+				}
+				else
+				{
+					str[j] = (r & 1) ? hex_digit_map[r % 16] : Byte_util::ascii_to_lower(hex_digit_map[r % 16]);
+				}
+			}
+
+			uint64_t expected = 0;
+			const bool expected_ret = Byte_util::hex_str_to_uT<uint64_t>(str, &expected);
+
+			uint64_t output = 0;
+			ASSERT_EQ(Byte_util::hex_str_to_u64(str, &output), expected_ret);
+			ASSERT_EQ(output, expected);
+		}
+	}
+
+	TEST(Byte_util, hex_encode_matches_scalar)
+	{
+		std::vector<uint8_t> input(300);
+		for(size_t i = 0; i < input.size(); i++)
+		{
+			input[i] = uint8_t(i * 37U + 11U);
+		}
+
+		//cover every tail length around the 16 and 32 byte SIMD blocks
+		for(size_t len = 0; len <= input.size(); len++)
+		{
+			std::vector<char> expected(2*len);
+			std::vector<char> output(2*len);
+
+			Byte_util::hex_encode_scalar(input.data(), len, expected.data());
+			Byte_util::hex_encode(input.data(), len, output.data());
+
+			ASSERT_EQ(output, expected);
+		}
+	}
+
+	TEST(Byte_util, hex_encode_domain)
+	{
+		std::array<uint8_t, 256> input;
+		for(size_t i = 0; i < input.size(); i++)
+		{
+			input[i] = i;
+		}
+
+		std::array<char, 512> output;
+		Byte_util::hex_encode(input.data(), input.size(), output.data());
+
+		for(size_t i = 0; i < input.size(); i++)
+		{
+			EXPECT_EQ(output[2*i+0], hex_digit_map[i / 16]);
+			EXPECT_EQ(output[2*i+1], hex_digit_map[i % 16]);
+		}
+	}
+
+	TEST(Byte_util, hex_decode_round_trip)
+	{
+		std::vector<uint8_t> input(300);
+		for(size_t i = 0; i < input.size(); i++)
+		{
+			input[i] = uint8_t(i * 151U + 3U);
+		}
+
+		for(size_t len = 0; len <= input.size(); len++)
+		{
+			std::vector<char> hex(2*len);
+			Byte_util::hex_encode(input.data(), len, hex.data());
+
+			std::vector<uint8_t> output(len);
+			size_t err_idx = 0;
+			ASSERT_TRUE(Byte_util::hex_decode(hex.data(), hex.size(), output.data(), &err_idx));
+			ASSERT_TRUE(std::equal(output.begin(), output.end(), input.begin()));
+		}
+	}
+
+	TEST(Byte_util, hex_decode_mixed_case)
+	{
+		const char upper[] = "0123456789ABCDEF0123456789ABCDEF0123456789ABCDEF0123456789ABCDEF0123456789ABCDEF";
+		const char lower[] = "0123456789abcdef0123456789abcdef0123456789abcdef0123456789abcdef0123456789abcdef";
+		const char mixed[] = "0123456789aBcDeF0123456789AbCdEf0123456789abcdef0123456789ABCDEF0123456789aBCdeF";
+
+		std::array<uint8_t, 40> expected;
+		std::array<uint8_t, 40> output;
+		ASSERT_TRUE(Byte_util::hex_decode(upper, 80, expected.data()));
+
+		ASSERT_TRUE(Byte_util::hex_decode(lower, 80, output.data()));
+		EXPECT_EQ(output, expected);
+
+		ASSERT_TRUE(Byte_util::hex_decode(mixed, 80, output.data()));
+		EXPECT_EQ(output, expected);
+	}
+
+	TEST(Byte_util, hex_decode_first_invalid)
+	{
+		const std::array<char, 8> bad_chars = {'G', 'g', '/', ':', '@', '`', char(0xB0), char(0xC1)};
+
+		std::vector<uint8_t> input(100);
+		for(size_t i = 0; i < input.size(); i++)
+		{
+			input[i] = uint8_t(i);
+		}
+
+		std::vector<char> hex(2*input.size());
+		Byte_util::hex_encode(input.data(), input.size(), hex.data());
+
+		std::vector<uint8_t> output(input.size());
+		for(const char bad : bad_chars)
+		{
+			for(size_t i = 0; i < hex.size(); i++)
+			{
+				std::vector<char> corrupt = hex;
+				corrupt[i] = bad;
+
+				//a second bad char later must not be reported
+				corrupt.back() = bad;
+
+				size_t err_idx = 0;
+				ASSERT_FALSE(Byte_util::hex_decode(corrupt.data(), corrupt.size(), output.data(), &err_idx));
+				ASSERT_EQ(err_idx, i);
+
+				ASSERT_FALSE(Byte_util::hex_decode_scalar(corrupt.data(), corrupt.size(), output.data(), &err_idx));
+				ASSERT_EQ(err_idx, i);
+			}
+		}
+	}
+
+	TEST(Byte_util, hex_decode_odd_length)
+	{
+		const char input[] = "0123456789ABCDEF0";
+		std::array<uint8_t, 8> output;
+
+		size_t err_idx = 0;
+		EXPECT_FALSE(Byte_util::hex_decode(input, 17, output.data(), &err_idx));
+		EXPECT_EQ(err_idx, 16);
+		EXPECT_THAT(output, ::testing::ElementsAre(0x01, 0x23, 0x45, 0x67, 0x89, 0xAB, 0xCD, 0xEF));
+
+		EXPECT_FALSE(Byte_util::hex_decode(input, 1, output.data()));
+	}
+
 	TEST(Byte_util, make_u16)
 	{
 		EXPECT_EQ(Byte_util::make_u16(0x00, 0x00), 0x0000);
@@ -82,4 +349,75 @@ namespace
 
 		EXPECT_EQ(Byte_util::make_u16(0xFF, 0xFF), 0xFFFF);
 	}
+
+	TEST(Byte_util, load_store)
+	{
+		const uint8_t buf[9] = {0xFF, 0x01, 0x23, 0x45, 0x67, 0x89, 0xAB, 0xCD, 0xEF};
+
+		//offset by one to check unaligned access
+		EXPECT_EQ(Byte_util::load_be<uint8_t>(buf + 1),  0x01);
+		EXPECT_EQ(Byte_util::load_be<uint16_t>(buf + 1), 0x0123);
+		EXPECT_EQ(Byte_util::load_be<uint32_t>(buf + 1), 0x01234567UL);
+		EXPECT_EQ(Byte_util::load_be<uint64_t>(buf + 1), 0x0123456789ABCDEFULL);
+		EXPECT_EQ(Byte_util::load_be<int16_t>(buf + 7), int16_t(0xCDEF));
+
+		EXPECT_EQ(Byte_util::load_le<uint16_t>(buf + 1), 0x2301);
+		EXPECT_EQ(Byte_util::load_le<uint32_t>(buf + 1), 0x67452301UL);
+		EXPECT_EQ(Byte_util::load_le<uint64_t>(buf + 1), 0xEFCDAB8967452301ULL);
+		EXPECT_EQ(Byte_util::load_le<int32_t>(buf + 5), int32_t(0xEFCDAB89));
+
+		EXPECT_EQ(Byte_util::load_be<uint32_t>(buf + 1), Byte_util::make_u32(buf[1], buf[2], buf[3], buf[4]));
+
+		uint8_t out[9] = {0};
+		Byte_util::store_be<uint64_t>(out + 1, 0x0123456789ABCDEFULL);
+		EXPECT_TRUE(std::equal(out + 1, out + 9, buf + 1));
+		EXPECT_EQ(out[0], 0);
+
+		Byte_util::store_le<uint32_t>(out + 1, 0x67452301UL);
+		EXPECT_TRUE(std::equal(out + 1, out + 5, buf + 1));
+
+		Byte_util::store_be<int16_t>(out + 1, int16_t(0x0123));
+		EXPECT_TRUE(std::equal(out + 1, out + 3, buf + 1));
+
+		Byte_util::store_le<uint16_t>(out + 1, 0x2301);
+		EXPECT_TRUE(std::equal(out + 1, out + 3, buf + 1));
+	}
+
+	TEST(Byte_util, bswap)
+	{
+		EXPECT_EQ(Byte_util::bswap_16(0x0123), 0x2301);
+		EXPECT_EQ(Byte_util::bswap_32(0x01234567UL), 0x67452301UL);
+		EXPECT_EQ(Byte_util::bswap_64(0x0123456789ABCDEFULL), 0xEFCDAB8967452301ULL);
+	}
+
+	template<typename T>
+	void check_bswap_n(T (*bswap)(T))
+	{
+		//cover the SIMD block sizes and the scalar tail
+		for(size_t n = 0; n < 70; n++)
+		{
+			std::vector<T> data(n + 2);
+			for(size_t i = 0; i < data.size(); i++)
+			{
+				data[i] = T(0x0123456789ABCDEFULL * (i + 1));
+			}
+
+			std::vector<T> expected = data;
+			for(size_t i = 1; i < (n + 1); i++)
+			{
+				expected[i] = bswap(expected[i]);
+			}
+
+			//unaligned start, guard elements on each end
+			Byte_util::bswap_n(data.data() + 1, n);
+			ASSERT_EQ(data, expected);
+		}
+	}
+
+	TEST(Byte_util, bswap_n)
+	{
+		check_bswap_n<uint16_t>(&Byte_util::bswap_16);
+		check_bswap_n<uint32_t>(&Byte_util::bswap_32);
+		check_bswap_n<uint64_t>(&Byte_util::bswap_64);
+	}
 }
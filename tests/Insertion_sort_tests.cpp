@@ -3,7 +3,11 @@
 #include "gtest/gtest.h"
 #include "gmock/gmock.h"
 
+#include <algorithm>
 #include <array>
+#include <list>
+#include <utility>
+#include <vector>
 
 namespace
 {
@@ -23,4 +27,65 @@ namespace
 
 		EXPECT_THAT(array, ::testing::ElementsAre(0, 1, 2, 3, 4, 5, 6, 7, 8, 9));
 	}
+
+	struct Key_lt
+	{
+		bool operator()(const std::pair<int, int>& lhs, const std::pair<int, int>& rhs) const
+		{
+			return lhs.first < rhs.first;
+		}
+	};
+
+	template<typename Policy>
+	void check_policy()
+	{
+		//keys repeat, second is the original position to check stability
+		std::vector< std::pair<int, int> > v;
+		uint32_t seed = 99;
+		for(int i = 0; i < 300; i++)
+		{
+			seed = seed * 1103515245U + 12345U;
+			v.push_back(std::make_pair(int((seed >> 16) % 20), i));
+		}
+
+		std::vector< std::pair<int, int> > ref = v;
+		std::stable_sort(ref.begin(), ref.end(), Key_lt());
+
+		insertion_sort(v.begin(), v.end(), Key_lt(), Policy());
+		EXPECT_EQ(v, ref);
+
+		//bidirectional iterators
+		std::list<int> list = {5, 1, 4, 1, 3, 9, 2, 6};
+		insertion_sort(list.begin(), list.end(), std::less<int>(), Policy());
+		EXPECT_THAT(list, ::testing::ElementsAre(1, 1, 2, 3, 4, 5, 6, 9));
+
+		std::array<int, 1> one = {1};
+		insertion_sort(one.begin(), one.end(), std::less<int>(), Policy());
+		insertion_sort(one.begin(), one.begin(), std::less<int>(), Policy());
+	}
+
+	TEST(Insertion_sort, policy_swap)
+	{
+		check_policy<Insertion_sort_swap>();
+	}
+
+	TEST(Insertion_sort, policy_move)
+	{
+		check_policy<Insertion_sort_move>();
+	}
+
+	TEST(Insertion_sort, policy_binary)
+	{
+		check_policy<Insertion_sort_binary>();
+	}
+
+	TEST(Insertion_sort, policy_unguarded)
+	{
+		//array[0] is the sentinel and not part of the sorted range
+		std::array<int, 11> array = {-1, 9, 3, 7, 3, 0, 8, 1, 6, 2, 5};
+
+		insertion_sort(array.begin() + 1, array.end(), std::less<int>(), Insertion_sort_unguarded());
+
+		EXPECT_THAT(array, ::testing::ElementsAre(-1, 0, 1, 2, 3, 3, 5, 6, 7, 8, 9));
+	}
 }
@@ -0,0 +1,176 @@
+#include "common_util/Adaptive_sort.hpp"
+
+#include "Test_util.hpp"
+
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace
+{
+	struct Record
+	{
+		uint32_t key;
+		uint32_t seq;
+
+		bool operator==(const Record& rhs) const
+		{
+			return (key == rhs.key) && (seq == rhs.seq);
+		}
+	};
+
+	struct Record_lt
+	{
+		bool operator()(const Record& lhs, const Record& rhs) const
+		{
+			return lhs.key < rhs.key;
+		}
+	};
+
+	std::vector<Record> make_records(const std::vector<uint32_t>& keys)
+	{
+		std::vector<Record> v(keys.size());
+		for(size_t i = 0; i < v.size(); i++)
+		{
+			v[i].key = keys[i];
+			v[i].seq = uint32_t(i);
+		}
+		return v;
+	}
+
+	//compare against std::stable_sort with no buffer, the default stack buffer, a small buffer and a n / 2 buffer
+	void check_stable(const std::vector<uint32_t>& keys)
+	{
+		const std::vector<Record> input = make_records(keys);
+
+		std::vector<Record> expected = input;
+		std::stable_sort(expected.begin(), expected.end(), Record_lt());
+
+		std::vector<Record> v = input;
+		adaptive_sort(v.begin(), v.end(), static_cast<Record*>(nullptr), 0, Record_lt());
+		EXPECT_TRUE(expected == v) << "no buffer n " << keys.size();
+
+		v = input;
+		adaptive_sort(v.begin(), v.end(), Record_lt());
+		EXPECT_TRUE(expected == v) << "stack buffer n " << keys.size();
+
+		v = input;
+		std::vector<Record> small_buf(5);
+		adaptive_sort(v.begin(), v.end(), small_buf.begin(), small_buf.size(), Record_lt());
+		EXPECT_TRUE(expected == v) << "small buffer n " << keys.size();
+
+		v = input;
+		std::vector<Record> buf(keys.size() / 2);
+		adaptive_sort(v.begin(), v.end(), buf.data(), buf.size(), Record_lt());
+		EXPECT_TRUE(expected == v) << "n / 2 buffer n " << keys.size();
+	}
+
+	TEST(Adaptive_sort, gallop_matches_bounds)
+	{
+		const std::vector<uint32_t> v = {1, 2, 2, 2, 3, 5, 5, 8, 9, 9, 9, 9, 12};
+		for(uint32_t x = 0; x < 14; x++)
+		{
+			EXPECT_EQ(std::lower_bound(v.begin(), v.end(), x), adaptive_sort_gallop_lower(v.begin(), v.end(), x, std::less<uint32_t>()));
+			EXPECT_EQ(std::upper_bound(v.begin(), v.end(), x), adaptive_sort_gallop_upper(v.begin(), v.end(), x, std::less<uint32_t>()));
+			EXPECT_EQ(std::lower_bound(v.begin(), v.end(), x), adaptive_sort_gallop_lower_back(v.begin(), v.end(), x, std::less<uint32_t>()));
+			EXPECT_EQ(std::upper_bound(v.begin(), v.end(), x), adaptive_sort_gallop_upper_back(v.begin(), v.end(), x, std::less<uint32_t>()));
+		}
+	}
+
+	TEST(Adaptive_sort, min_run)
+	{
+		EXPECT_EQ(0U, adaptive_sort_min_run(0));
+		EXPECT_EQ(63U, adaptive_sort_min_run(63));
+		EXPECT_EQ(32U, adaptive_sort_min_run(64));
+		EXPECT_EQ(33U, adaptive_sort_min_run(65));
+		EXPECT_EQ(32U, adaptive_sort_min_run(1 << 20));
+	}
+
+	TEST(Adaptive_sort, small)
+	{
+		for(size_t n = 0; n < 100; n++)
+		{
+			check_stable(make_random(n, 10, uint32_t(n)));
+		}
+	}
+
+	TEST(Adaptive_sort, random)
+	{
+		for(size_t n : {1000, 10000, 100000})
+		{
+			check_stable(make_random(n, 0, uint32_t(n)));
+			check_stable(make_random(n, 50, uint32_t(n + 1)));
+		}
+	}
+
+	TEST(Adaptive_sort, presorted)
+	{
+		std::vector<uint32_t> v(20000);
+		for(size_t i = 0; i < v.size(); i++)
+		{
+			v[i] = uint32_t(i / 3);
+		}
+		check_stable(v);
+
+		//descending with equal neighbours, only strictly descending runs are reversed
+		std::vector<uint32_t> r(v.rbegin(), v.rend());
+		check_stable(r);
+
+		//late arrivals
+		std::vector<uint32_t> late = v;
+		for(size_t i = 0; i < late.size(); i += 500)
+		{
+			late[i] = uint32_t(i / 5);
+		}
+		check_stable(late);
+
+		//sawtooth of runs with different lengths
+		std::vector<uint32_t> saw;
+		for(size_t run = 1; saw.size() < 30000; run = (run * 7) % 997 + 1)
+		{
+			for(size_t i = 0; i < run; i++)
+			{
+				saw.push_back(uint32_t(i));
+			}
+		}
+		check_stable(saw);
+	}
+
+	TEST(Adaptive_sort, move_only)
+	{
+		const std::vector<uint32_t> keys = make_random(5000, 100, 3);
+
+		std::vector< std::unique_ptr<uint32_t> > v;
+		for(uint32_t k : keys)
+		{
+			v.emplace_back(new uint32_t(k));
+		}
+
+		adaptive_sort(v.begin(), v.end(), [](const std::unique_ptr<uint32_t>& lhs, const std::unique_ptr<uint32_t>& rhs)
+		{
+			return *lhs < *rhs;
+		});
+
+		std::vector<uint32_t> expected = keys;
+		std::sort(expected.begin(), expected.end());
+		for(size_t i = 0; i < v.size(); i++)
+		{
+			ASSERT_EQ(expected[i], *v[i]);
+		}
+	}
+
+	TEST(Adaptive_sort, default_less)
+	{
+		std::vector<uint32_t> v = make_random(3000, 0, 5);
+		std::vector<uint32_t> expected = v;
+		std::sort(expected.begin(), expected.end());
+
+		adaptive_sort(v.begin(), v.end());
+		EXPECT_EQ(expected, v);
+	}
+}
@@ -0,0 +1,249 @@
+#include "common_util/Atomic_intrusive_slist.hpp"
+
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace
+{
+	struct Block : public Intrusive_slist_node
+	{
+		uint32_t id;
+		std::atomic<uint32_t> owners;
+	};
+
+	TEST(Atomic_intrusive_slist, empty)
+	{
+		Atomic_intrusive_slist stack;
+
+		ASSERT_TRUE(stack.empty());
+		ASSERT_EQ(stack.pop(), nullptr);
+		ASSERT_EQ(stack.pop_all(), nullptr);
+	}
+
+	TEST(Atomic_intrusive_slist, push_pop)
+	{
+		std::vector<Intrusive_slist_node> n(3);
+
+		Atomic_intrusive_slist stack;
+		for(size_t i = 0; i < n.size(); i++)
+		{
+			stack.push(&n[i]);
+		}
+		ASSERT_FALSE(stack.empty());
+
+		ASSERT_EQ(stack.pop(), &n[2]);
+		ASSERT_EQ(stack.pop(), &n[1]);
+		ASSERT_EQ(stack.pop(), &n[0]);
+		ASSERT_EQ(stack.pop(), nullptr);
+		ASSERT_TRUE(stack.empty());
+	}
+
+	TEST(Atomic_intrusive_slist, push_chain_pop_all)
+	{
+		std::vector<Intrusive_slist_node> n(5);
+
+		Atomic_intrusive_slist stack;
+		stack.push(&n[4]);
+
+		//n[0] -> n[1] -> n[2] linked by an Intrusive_slist
+		Intrusive_slist chain;
+		chain.push_front(&n[2]);
+		chain.push_front(&n[1]);
+		chain.push_front(&n[0]);
+		stack.push_chain(&n[0], &n[2]);
+
+		stack.push(&n[3]);
+
+		Intrusive_slist_node* node = stack.pop_all();
+		ASSERT_TRUE(stack.empty());
+
+		const std::vector<Intrusive_slist_node*> expected = {&n[3], &n[0], &n[1], &n[2], &n[4]};
+		for(size_t i = 0; i < expected.size(); i++)
+		{
+			ASSERT_EQ(node, expected[i]);
+			node = node->next();
+		}
+		ASSERT_EQ(node, nullptr);
+	}
+
+	//every thread pops and pushes back blocks from a shared free list, no block may be held by two threads at once or lost
+	TEST(Atomic_intrusive_slist, stress)
+	{
+		const size_t NUM_THREADS = 8;
+		const size_t NUM_BLOCKS  = 64;
+		const size_t NUM_ITER    = 20000;
+
+		std::vector<Block> blocks(NUM_BLOCKS);
+		Atomic_intrusive_slist free_list;
+		for(size_t i = 0; i < blocks.size(); i++)
+		{
+			blocks[i].id = uint32_t(i);
+			blocks[i].owners = 0;
+			free_list.push(&blocks[i]);
+		}
+
+		std::atomic<bool> double_owned(false);
+		std::vector<std::thread> threads;
+		for(size_t t = 0; t < NUM_THREADS; t++)
+		{
+			threads.emplace_back([&free_list, &double_owned, t]()
+			{
+				Block* held[4] = {nullptr, nullptr, nullptr, nullptr};
+				for(size_t i = 0; i < NUM_ITER; i++)
+				{
+					const size_t slot = (i + t) % 4;
+					if(held[slot])
+					{
+						held[slot]->owners.fetch_sub(1);
+						free_list.push(held[slot]);
+						held[slot] = nullptr;
+					}
+					else
+					{
+						held[slot] = free_list.pop<Block>();
+						if(held[slot] && (held[slot]->owners.fetch_add(1) != 0))
+						{
+							double_owned = true;
+						}
+					}
+
+					//now and then take everything and give it back as one chain
+					if((i % 1024) == t)
+					{
+						Intrusive_slist_node* first = free_list.pop_all();
+						if(first)
+						{
+							Intrusive_slist_node* last = first;
+							while(last->next())
+							{
+								last = last->next();
+							}
+							free_list.push_chain(first, last);
+						}
+					}
+				}
+
+				for(Block* b : held)
+				{
+					if(b)
+					{
+						b->owners.fetch_sub(1);
+						free_list.push(b);
+					}
+				}
+			});
+		}
+
+		for(std::thread& t : threads)
+		{
+			t.join();
+		}
+
+		ASSERT_FALSE(double_owned.load());
+
+		std::vector<uint32_t> seen(NUM_BLOCKS, 0);
+		Block* b = free_list.pop_all<Block>();
+		while(b)
+		{
+			seen[b->id]++;
+			b = b->next<Block>();
+		}
+
+		for(size_t i = 0; i < NUM_BLOCKS; i++)
+		{
+			ASSERT_EQ(seen[i], 1U) << "block " << i;
+		}
+	}
+
+	//the same free list as a std::mutex around an Intrusive_slist
+	class Mutex_free_list
+	{
+	public:
+		void push(Intrusive_slist_node* const node)
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_list.push_front(node);
+		}
+
+		Intrusive_slist_node* pop()
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			Intrusive_slist_node* const node = m_list.front<Intrusive_slist_node>();
+			m_list.pop_front();
+			return node;
+		}
+
+	protected:
+		std::mutex m_mutex;
+		Intrusive_slist m_list;
+	};
+
+	//ns per pop + push pair with num_threads threads hammering one free list
+	template<typename Free_list>
+	double free_list_ns_per_op(const size_t num_threads)
+	{
+		constexpr size_t NUM_BLOCKS = 1024;
+		constexpr size_t NUM_OPS = 1000000;
+
+		std::vector<Intrusive_slist_node> blocks(NUM_BLOCKS);
+		Free_list free_list;
+		for(Intrusive_slist_node& b : blocks)
+		{
+			free_list.push(&b);
+		}
+
+		std::atomic<bool> go(false);
+		std::vector<std::thread> threads;
+		for(size_t t = 0; t < num_threads; t++)
+		{
+			threads.emplace_back([&free_list, &go, num_threads]()
+			{
+				while(!go)
+				{
+					std::this_thread::yield();
+				}
+
+				for(size_t i = 0; i < NUM_OPS / num_threads; i++)
+				{
+					Intrusive_slist_node* const node = free_list.pop();
+					if(node)
+					{
+						free_list.push(node);
+					}
+				}
+			});
+		}
+
+		const auto start = std::chrono::steady_clock::now();
+		go = true;
+		for(std::thread& t : threads)
+		{
+			t.join();
+		}
+		const auto end = std::chrono::steady_clock::now();
+
+		return std::chrono::duration<double, std::nano>(end - start).count() / double(NUM_OPS);
+	}
+
+	//contention benchmark against the mutex version, run with --gtest_also_run_disabled_tests on a machine with many cores
+	TEST(Atomic_intrusive_slist, DISABLED_contention_benchmark)
+	{
+		const size_t hw_threads = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+		printf("hardware threads %zu\n", hw_threads);
+
+		for(const size_t num_threads : {size_t(1), size_t(2), size_t(4), size_t(8), size_t(16), size_t(32), hw_threads})
+		{
+			const double mutex_ns = free_list_ns_per_op<Mutex_free_list>(num_threads);
+			const double atomic_ns = free_list_ns_per_op<Atomic_intrusive_slist>(num_threads);
+			printf("%3zu threads: mutex %6.1f ns/op, atomic %6.1f ns/op\n", num_threads, mutex_ns, atomic_ns);
+		}
+	}
+}
@@ -0,0 +1,162 @@
+#include "common_util/Bit_stream.hpp"
+
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+
+#include <array>
+#include <vector>
+
+namespace
+{
+	//a packed sensor frame, 3 + 12 + 17 bit fields in one big endian word
+	TEST(Bit_stream, read_matches_mask_rshift)
+	{
+		const uint32_t a = 0x5;
+		const uint32_t b = 0xABC;
+		const uint32_t c = 0x1F0F0;
+
+		const uint32_t word = Byte_util::mask_rshift(a, uint32_t(0x7), 29) | Byte_util::mask_rshift(b, uint32_t(0xFFF), 17) | Byte_util::mask_rshift(c, uint32_t(0x1FFFF), 0);
+
+		std::array<uint8_t, 4> buf;
+		Byte_util::store_be<uint32_t>(buf.data(), word);
+
+		Bit_reader_msb reader(buf.data(), buf.size());
+		EXPECT_EQ(reader.read(3), a);
+		EXPECT_EQ(reader.read(12), b);
+		EXPECT_EQ(reader.read(17), c);
+		EXPECT_EQ(reader.bits_remaining(), 0);
+		EXPECT_FALSE(reader.overrun());
+	}
+
+	TEST(Bit_stream, write_matches_mask_lshift)
+	{
+		std::array<uint8_t, 4> buf;
+
+		Bit_writer_msb writer(buf.data(), buf.size());
+		writer.write(0x5, 3);
+		writer.write(0xABC, 12);
+		writer.write(0x1F0F0, 17);
+		EXPECT_TRUE(writer.flush());
+		EXPECT_EQ(writer.bytes_written(), 4);
+
+		const uint32_t word = Byte_util::load_be<uint32_t>(buf.data());
+		EXPECT_EQ(Byte_util::mask_lshift(word, uint32_t(0xE0000000), 29), 0x5);
+		EXPECT_EQ(Byte_util::mask_lshift(word, uint32_t(0x1FFE0000), 17), 0xABC);
+		EXPECT_EQ(Byte_util::mask_lshift(word, uint32_t(0x0001FFFF), 0), 0x1F0F0);
+	}
+
+	TEST(Bit_stream, lsb_first)
+	{
+		const std::array<uint8_t, 2> buf = {0xA5, 0x0F};
+
+		Bit_reader_lsb reader(buf.data(), buf.size());
+		EXPECT_EQ(reader.read(1), 1);
+		EXPECT_EQ(reader.read(3), 2);
+		EXPECT_EQ(reader.read(8), 0xFA);
+		EXPECT_EQ(reader.read(4), 0);
+
+		std::array<uint8_t, 2> out;
+		Bit_writer_lsb writer(out.data(), out.size());
+		writer.write(1, 1);
+		writer.write(2, 3);
+		writer.write(0xFA, 8);
+		writer.write(0, 4);
+		EXPECT_TRUE(writer.flush());
+		EXPECT_EQ(out, buf);
+	}
+
+	TEST(Bit_stream, overrun)
+	{
+		const std::array<uint8_t, 2> buf = {0xFF, 0xFF};
+
+		Bit_reader_msb reader(buf.data(), buf.size());
+		EXPECT_EQ(reader.read(12), 0xFFF);
+		EXPECT_FALSE(reader.overrun());
+
+		//4 bits left, the rest read as 0
+		EXPECT_EQ(reader.read(8), 0xF0);
+		EXPECT_TRUE(reader.overrun());
+
+		std::array<uint8_t, 1> out;
+		Bit_writer_msb writer(out.data(), out.size());
+		writer.write(0x3FF, 10);
+		EXPECT_FALSE(writer.flush());
+		EXPECT_TRUE(writer.overrun());
+		EXPECT_EQ(out[0], 0xFF);
+	}
+
+	template<Bit_order ORDER>
+	void check_round_trip()
+	{
+		std::vector<uint8_t> widths;
+		std::vector<uint32_t> fields;
+
+		uint32_t seed = 7;
+		for(size_t i = 0; i < 5000; i++)
+		{
+			seed = seed * 1103515245U + 12345U;
+			const uint8_t width = (seed >> 16) % 33;
+
+			seed = seed * 1103515245U + 12345U;
+			const uint32_t field = (width == 32) ? seed : (seed & ((1U << width) - 1U));
+
+			widths.push_back(width);
+			fields.push_back(field);
+		}
+
+		std::vector<uint8_t> buf(5000 * 4 + 1);
+		Bit_writer<ORDER> writer(buf.data(), buf.size());
+		for(size_t i = 0; i < fields.size(); i++)
+		{
+			writer.write(fields[i], widths[i]);
+		}
+		ASSERT_TRUE(writer.flush());
+
+		Bit_reader<ORDER> reader(buf.data(), writer.bytes_written());
+		for(size_t i = 0; i < fields.size(); i++)
+		{
+			ASSERT_EQ(reader.read(widths[i]), fields[i]);
+		}
+		EXPECT_LT(reader.bits_remaining(), 8);
+		EXPECT_FALSE(reader.overrun());
+	}
+
+	TEST(Bit_stream, round_trip)
+	{
+		check_round_trip<Bit_order::MSB_FIRST>();
+		check_round_trip<Bit_order::LSB_FIRST>();
+	}
+
+	template<Bit_order ORDER>
+	void check_read_n(const uint8_t nbits)
+	{
+		std::vector<uint32_t> fields(1001);
+		for(size_t i = 0; i < fields.size(); i++)
+		{
+			fields[i] = uint32_t((i * 2654435761U) & ((uint64_t(1) << nbits) - 1U));
+		}
+
+		std::vector<uint8_t> buf((fields.size() * nbits + 7) / 8);
+		Bit_writer<ORDER> writer(buf.data(), buf.size());
+		writer.write_n(fields.data(), fields.size(), nbits);
+		ASSERT_TRUE(writer.flush());
+
+		//lead with an odd field so the batch starts unaligned
+		Bit_reader<ORDER> reader(buf.data(), buf.size());
+		std::vector<uint32_t> out(fields.size());
+		out[0] = reader.read(nbits);
+		reader.read_n(out.data() + 1, out.size() - 1, nbits);
+
+		ASSERT_EQ(out, fields);
+		EXPECT_FALSE(reader.overrun());
+	}
+
+	TEST(Bit_stream, read_n)
+	{
+		for(uint8_t nbits = 1; nbits <= 32; nbits++)
+		{
+			check_read_n<Bit_order::MSB_FIRST>(nbits);
+			check_read_n<Bit_order::LSB_FIRST>(nbits);
+		}
+	}
+}
@@ -0,0 +1,196 @@
+#include "common_util/Hex_dumper.hpp"
+#include "common_util/Stack_string.hpp"
+
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+
+#include <string>
+#include <vector>
+
+namespace
+{
+	std::string dump_all(Hex_dumper* const dumper, const uint8_t* const data, const size_t len)
+	{
+		std::vector<char> out(dumper->line_len() * (len / 16 + 2));
+
+		size_t written = 0;
+		EXPECT_EQ(dumper->write(data, len, out.data(), out.size(), &written), len);
+
+		size_t flushed = 0;
+		EXPECT_TRUE(dumper->flush(out.data() + written, out.size() - written, &flushed));
+
+		return std::string(out.data(), written + flushed);
+	}
+
+	TEST(Hex_dumper, line_format)
+	{
+		const char input[] = "Hello, World!\n\x00\x7F\x80\xFF";
+
+		Hex_dumper dumper;
+		const std::string out = dump_all(&dumper, reinterpret_cast<const uint8_t*>(input), sizeof(input) - 1);
+
+		EXPECT_EQ(out,
+			"00000000: 4865 6C6C 6F2C 2057 6F72 6C64 210A 007F  Hello, World!...\n"
+			"00000010: 80FF                                     ..\n"
+		);
+	}
+
+	TEST(Hex_dumper, line_len)
+	{
+		Hex_dumper dumper;
+		EXPECT_EQ(dumper.line_len(), 10 + 39 + 18 + 1);
+
+		dumper.set_group(0);
+		dumper.set_offset_digits(0);
+		dumper.set_show_ascii(false);
+		EXPECT_EQ(dumper.line_len(), 33);
+
+		EXPECT_FALSE(dumper.set_width(0));
+		EXPECT_FALSE(dumper.set_width(Hex_dumper::MAX_WIDTH + 1));
+		EXPECT_FALSE(dumper.set_offset_digits(4));
+	}
+
+	TEST(Hex_dumper, config)
+	{
+		const uint8_t input[] = {0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88, 0x99};
+
+		Hex_dumper dumper;
+		ASSERT_TRUE(dumper.set_width(8));
+		dumper.set_group(4);
+		dumper.set_offset_digits(0);
+		dumper.set_show_ascii(false);
+
+		EXPECT_EQ(dump_all(&dumper, input, sizeof(input)),
+			"00112233 44556677\n"
+			"8899             \n"
+		);
+	}
+
+	TEST(Hex_dumper, set_width_partial_line)
+	{
+		std::vector<uint8_t> input(200);
+		for(size_t i = 0; i < input.size(); i++)
+		{
+			input[i] = uint8_t(i);
+		}
+
+		Hex_dumper dumper;
+		std::vector<char> out(dumper.line_len() * 16);
+
+		//10 bytes stay buffered in a 16 byte line, shrinking the line under them is refused
+		size_t written = 0;
+		EXPECT_EQ(dumper.write(input.data(), 10, out.data(), out.size(), &written), 10);
+		EXPECT_EQ(written, 0);
+		EXPECT_FALSE(dumper.set_width(4));
+
+		EXPECT_EQ(dumper.write(input.data() + 10, 190, out.data(), out.size(), &written), 190);
+		EXPECT_EQ(written, dumper.line_len() * 12);
+
+		size_t flushed = 0;
+		ASSERT_TRUE(dumper.flush(out.data(), out.size(), &flushed));
+		EXPECT_GT(flushed, 0);
+		EXPECT_LE(flushed, dumper.line_len());
+
+		//nothing buffered after the flush
+		EXPECT_TRUE(dumper.set_width(4));
+	}
+
+	TEST(Hex_dumper, offset_64)
+	{
+		const uint8_t input[] = {0xDE, 0xAD};
+
+		Hex_dumper dumper;
+		ASSERT_TRUE(dumper.set_offset_digits(16));
+		dumper.reset(0x123456789ABCDEF0ULL);
+
+		EXPECT_EQ(dump_all(&dumper, input, sizeof(input)),
+			"123456789ABCDEF0: DEAD                                     ..\n"
+		);
+		EXPECT_EQ(dumper.offset(), 0x123456789ABCDEF2ULL);
+	}
+
+	TEST(Hex_dumper, chunked_input)
+	{
+		std::vector<uint8_t> input(1000);
+		for(size_t i = 0; i < input.size(); i++)
+		{
+			input[i] = uint8_t(i * 7U);
+		}
+
+		Hex_dumper ref_dumper;
+		const std::string expected = dump_all(&ref_dumper, input.data(), input.size());
+
+		//odd sized input chunks and an output buffer that only fits one line
+		for(size_t chunk = 1; chunk < 40; chunk += 3)
+		{
+			Hex_dumper dumper;
+			std::vector<char> line(dumper.line_len());
+			std::string out;
+
+			size_t pos = 0;
+			while(pos < input.size())
+			{
+				const size_t len = std::min(chunk, input.size() - pos);
+
+				size_t written = 0;
+				pos += dumper.write(input.data() + pos, len, line.data(), line.size(), &written);
+				out.append(line.data(), written);
+			}
+
+			size_t written = 0;
+			do
+			{
+				dumper.write(nullptr, 0, line.data(), line.size(), &written);
+				out.append(line.data(), written);
+			} while(written != 0);
+
+			ASSERT_TRUE(dumper.flush(line.data(), line.size(), &written));
+			out.append(line.data(), written);
+
+			ASSERT_EQ(out, expected);
+		}
+	}
+
+	TEST(Hex_dumper, output_too_small)
+	{
+		const uint8_t input[32] = {0};
+
+		Hex_dumper dumper;
+		std::vector<char> out(dumper.line_len() - 1);
+
+		size_t written = 0;
+		EXPECT_EQ(dumper.write(input, sizeof(input), out.data(), out.size(), &written), 0);
+		EXPECT_EQ(written, 0);
+
+		//a partial line is buffered even without output space
+		EXPECT_EQ(dumper.write(input, 5, out.data(), out.size(), &written), 5);
+		EXPECT_EQ(written, 0);
+		EXPECT_FALSE(dumper.flush(out.data(), dumper.line_len() - 16 + 5 - 1, &written));
+		EXPECT_EQ(dumper.offset(), 5);
+
+		EXPECT_TRUE(dumper.flush(out.data(), dumper.line_len() - 16 + 5, &written));
+		EXPECT_EQ(written, dumper.line_len() - 16 + 5);
+		EXPECT_EQ(dumper.offset(), 5);
+	}
+
+	TEST(Hex_dumper, stack_string)
+	{
+		const char input[] = "0123456789abcdefXYZ";
+
+		Hex_dumper dumper;
+		Stack_string<128> str;
+
+		EXPECT_EQ(dumper.write(reinterpret_cast<const uint8_t*>(input), sizeof(input) - 1, &str), sizeof(input) - 1);
+		EXPECT_STREQ(str.c_str(), "00000000: 3031 3233 3435 3637 3839 6162 6364 6566  0123456789abcdef\n");
+
+		EXPECT_TRUE(dumper.flush(&str));
+		EXPECT_STREQ(str.c_str(),
+			"00000000: 3031 3233 3435 3637 3839 6162 6364 6566  0123456789abcdef\n"
+			"00000010: 5859 5A                                  XYZ\n"
+		);
+
+		//no room for another line
+		EXPECT_EQ(dumper.write(reinterpret_cast<const uint8_t*>(input), sizeof(input) - 1, &str), 0);
+		EXPECT_EQ(str.size(), 123);
+	}
+}
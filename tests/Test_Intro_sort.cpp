@@ -0,0 +1,106 @@
+#include "common_util/Intro_sort.hpp"
+
+#include "Test_util.hpp"
+
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+
+#include <algorithm>
+#include <array>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace
+{
+	template<typename T, typename Sort>
+	void check_against_std(std::vector<T> v, Sort sort)
+	{
+		std::vector<T> ref = v;
+		std::sort(ref.begin(), ref.end());
+
+		sort(v);
+		ASSERT_EQ(v, ref);
+	}
+
+	TEST(Intro_sort, null_range)
+	{
+		int* a = nullptr;
+
+		intro_sort(a, a);
+		heap_sort(a, a);
+	}
+
+	TEST(Intro_sort, patterns)
+	{
+		const auto do_intro = [](std::vector<uint32_t>& v){ intro_sort(v.begin(), v.end()); };
+
+		for(const size_t n : {1, 2, 3, 15, 16, 17, 100, 1000, 10007})
+		{
+			std::vector<uint32_t> sorted(n);
+			for(size_t i = 0; i < n; i++)
+			{
+				sorted[i] = i;
+			}
+
+			std::vector<uint32_t> reversed(sorted.rbegin(), sorted.rend());
+
+			//sorted with the largest element at the front
+			std::vector<uint32_t> rotated = sorted;
+			std::rotate(rotated.begin(), rotated.end() - 1, rotated.end());
+
+			std::vector<uint32_t> organ_pipe(n);
+			for(size_t i = 0; i < n; i++)
+			{
+				organ_pipe[i] = (i < n / 2) ? i : (n - i);
+			}
+
+			check_against_std(sorted, do_intro);
+			check_against_std(reversed, do_intro);
+			check_against_std(rotated, do_intro);
+			check_against_std(organ_pipe, do_intro);
+			check_against_std(make_random(n, 0, 12345), do_intro);
+			check_against_std(make_random(n, 4, 12345), do_intro);
+			check_against_std(std::vector<uint32_t>(n, 7), do_intro);
+		}
+	}
+
+	TEST(Intro_sort, comp)
+	{
+		std::vector<uint32_t> v = make_random(1000, 100, 12345);
+		intro_sort(v.begin(), v.end(), std::greater<uint32_t>());
+
+		EXPECT_TRUE(std::is_sorted(v.begin(), v.end(), std::greater<uint32_t>()));
+	}
+
+	TEST(Intro_sort, strings)
+	{
+		std::vector<std::string> v;
+		for(const uint32_t x : make_random(500, 50, 12345))
+		{
+			v.push_back(std::to_string(x));
+		}
+
+		check_against_std(v, [](std::vector<std::string>& s){ intro_sort(s.begin(), s.end()); });
+	}
+
+	TEST(Intro_sort, heap_sort)
+	{
+		const auto do_heap = [](std::vector<uint32_t>& v){ heap_sort(v.begin(), v.end()); };
+
+		for(const size_t n : {1, 2, 3, 4, 5, 31, 32, 33, 1000})
+		{
+			check_against_std(make_random(n, 0, 12345), do_heap);
+			check_against_std(make_random(n, 3, 12345), do_heap);
+		}
+	}
+
+	TEST(Intro_sort, array)
+	{
+		std::array<int, 10> array = {9, 8, 7, 6, 5, 4, 3, 2, 1, 0};
+
+		intro_sort(array.begin(), array.end());
+
+		EXPECT_THAT(array, ::testing::ElementsAre(0, 1, 2, 3, 4, 5, 6, 7, 8, 9));
+	}
+}
@@ -3,6 +3,9 @@
 #include "gtest/gtest.h"
 #include "gmock/gmock.h"
 
+#include <cstdint>
+#include <vector>
+
 namespace
 {
 	TEST(Intrusive_list, construct)
@@ -129,7 +132,7 @@ namespace
 			i++;
 		}
 	}
-#if 0
+
 	TEST(Intrusive_list, erase_last)
 	{
 		std::vector<Intrusive_list_node> node_storage;
@@ -195,7 +198,7 @@ namespace
 		ASSERT_EQ(front, &(node_storage[1]));
 		ASSERT_EQ(front->next<Intrusive_list_node>(), &(node_storage[0]));
 	}
-#endif
+
 	TEST(Intrusive_list, pop_front)
 	{
 		std::vector<Intrusive_list_node> node_storage;
@@ -544,4 +547,343 @@ namespace
 		}
 	}
 	#endif
+
+	struct Intrusive_list_job : public Intrusive_list_node
+	{
+		uint32_t key;
+		uint32_t seq;
+	};
+
+	struct Intrusive_list_job_lt
+	{
+		bool operator()(const Intrusive_list_job& lhs, const Intrusive_list_job& rhs) const
+		{
+			return lhs.key < rhs.key;
+		}
+	};
+
+	//sorted by key, equal keys in seq order, and every node still linked
+	void check_sorted(const Intrusive_list& list, const size_t expected_size)
+	{
+		typedef Intrusive_list_job Job;
+
+		size_t count = 0;
+		const Job* prev = nullptr;
+		const Job* node = list.front<Job>();
+		while(node)
+		{
+			if(prev)
+			{
+				ASSERT_EQ(node->prev<Job>(), prev);
+			}
+			prev = node;
+
+			const Job* next = node->next<Job>();
+			if(next)
+			{
+				ASSERT_LE(node->key, next->key);
+				if(node->key == next->key)
+				{
+					ASSERT_LT(node->seq, next->seq);
+				}
+			}
+
+			count++;
+			node = next;
+		}
+		ASSERT_EQ(count, expected_size);
+
+		//prev links and tail are rebuilt
+		ASSERT_EQ(list.back<Job>(), prev);
+		const Intrusive_list_node* back = list.back<Intrusive_list_node>();
+		for(size_t i = 0; i < count; i++)
+		{
+			back = back->prev();
+		}
+		ASSERT_EQ(back, nullptr);
+	}
+
+	std::vector<Intrusive_list_job> make_jobs(const size_t n, const uint32_t mod, uint32_t seed)
+	{
+		std::vector<Intrusive_list_job> jobs(n);
+		for(size_t i = 0; i < n; i++)
+		{
+			seed = seed * 1103515245U + 12345U;
+			jobs[i].key = (seed >> 16) % mod;
+			jobs[i].seq = uint32_t(i);
+		}
+		return jobs;
+	}
+
+	TEST(Intrusive_list, sort)
+	{
+		for(size_t n : {0, 1, 2, 3, 7, 16, 100, 1000})
+		{
+			std::vector<Intrusive_list_job> jobs = make_jobs(n, 10, uint32_t(n));
+
+			Intrusive_list list;
+			for(size_t i = 0; i < jobs.size(); i++)
+			{
+				list.push_back(&(jobs[i]));
+			}
+
+			list.sort<Intrusive_list_job>(Intrusive_list_job_lt());
+			check_sorted(list, n);
+		}
+	}
+
+	TEST(Intrusive_list, sort_presorted_and_reversed)
+	{
+		std::vector<Intrusive_list_job> jobs(257);
+		for(size_t i = 0; i < jobs.size(); i++)
+		{
+			jobs[i].key = uint32_t(i);
+			jobs[i].seq = uint32_t(i);
+		}
+
+		Intrusive_list list;
+		for(size_t i = 0; i < jobs.size(); i++)
+		{
+			list.push_back(&(jobs[i]));
+		}
+
+		list.sort<Intrusive_list_job>(Intrusive_list_job_lt());
+		check_sorted(list, jobs.size());
+
+		list.sort<Intrusive_list_job>([](const Intrusive_list_job& lhs, const Intrusive_list_job& rhs) { return lhs.key > rhs.key; });
+		ASSERT_EQ(list.front<Intrusive_list_job>(), &(jobs.back()));
+
+		list.sort<Intrusive_list_job>(Intrusive_list_job_lt());
+		check_sorted(list, jobs.size());
+	}
+
+	TEST(Intrusive_list, merge)
+	{
+		std::vector<Intrusive_list_job> jobs = make_jobs(50, 20, 1);
+		std::vector<Intrusive_list_job> jobs_b = make_jobs(70, 20, 2);
+		for(size_t i = 0; i < jobs_b.size(); i++)
+		{
+			jobs_b[i].seq += 1000;
+		}
+
+		Intrusive_list list;
+		for(size_t i = 0; i < jobs.size(); i++)
+		{
+			list.push_back(&(jobs[i]));
+		}
+		list.sort<Intrusive_list_job>(Intrusive_list_job_lt());
+
+		Intrusive_list other;
+		for(size_t i = 0; i < jobs_b.size(); i++)
+		{
+			other.push_back(&(jobs_b[i]));
+		}
+		other.sort<Intrusive_list_job>(Intrusive_list_job_lt());
+
+		list.merge<Intrusive_list_job>(other, Intrusive_list_job_lt());
+
+		ASSERT_TRUE(other.empty());
+		check_sorted(list, jobs.size() + jobs_b.size());
+
+		//merging into or from an empty list
+		Intrusive_list empty;
+		list.merge<Intrusive_list_job>(empty, Intrusive_list_job_lt());
+		check_sorted(list, jobs.size() + jobs_b.size());
+
+		empty.merge<Intrusive_list_job>(list, Intrusive_list_job_lt());
+		ASSERT_TRUE(list.empty());
+		check_sorted(empty, jobs.size() + jobs_b.size());
+	}
+
+	//the default keeps the two pointer layout
+	static_assert(sizeof(Intrusive_list) == 2 * sizeof(void*), "");
+	static_assert(sizeof(Intrusive_counted_list) == sizeof(Intrusive_list) + sizeof(size_t), "");
+
+	TEST(Intrusive_list, counted_size)
+	{
+		std::vector<Intrusive_list_node> node_storage;
+		node_storage.resize(8);
+
+		Intrusive_counted_list list;
+		ASSERT_EQ(list.size(), 0U);
+		for(size_t i = 0; i < 4; i++)
+		{
+			list.push_back(&(node_storage[i]));
+			ASSERT_EQ(list.size(), i + 1);
+		}
+		for(size_t i = 4; i < node_storage.size(); i++)
+		{
+			list.push_front(&(node_storage[i]));
+			ASSERT_EQ(list.size(), i + 1);
+		}
+
+		list.pop_front();
+		list.pop_back();
+		ASSERT_EQ(list.size(), 6U);
+
+		Intrusive_counted_list moved(std::move(list));
+		ASSERT_EQ(list.size(), 0U);
+		ASSERT_EQ(moved.size(), 6U);
+
+		Intrusive_counted_list other;
+		other.push_back(&(node_storage[3]));
+		other.push_back(&(node_storage[7]));
+		moved.merge<Intrusive_list_node>(other, [](const Intrusive_list_node& lhs, const Intrusive_list_node& rhs) { return &lhs < &rhs; });
+		ASSERT_EQ(other.size(), 0U);
+		ASSERT_EQ(moved.size(), 8U);
+
+		while(!moved.empty())
+		{
+			moved.pop_back();
+		}
+		ASSERT_EQ(moved.size(), 0U);
+
+		//popping an empty list leaves the count alone
+		moved.pop_front();
+		moved.pop_back();
+		ASSERT_EQ(moved.size(), 0U);
+	}
+
+	//walk the list both ways and compare against the expected node order
+	template<typename List>
+	void check_order(const List& list, const std::vector<Intrusive_list_node*>& expected)
+	{
+		ASSERT_EQ(list.size(), expected.size());
+
+		const Intrusive_list_node* node = list.template front<Intrusive_list_node>();
+		for(size_t i = 0; i < expected.size(); i++)
+		{
+			ASSERT_EQ(node, expected[i]);
+			node = node->next();
+		}
+		ASSERT_EQ(node, nullptr);
+
+		node = list.template back<Intrusive_list_node>();
+		for(size_t i = expected.size(); i > 0; i--)
+		{
+			ASSERT_EQ(node, expected[i - 1]);
+			node = node->prev();
+		}
+		ASSERT_EQ(node, nullptr);
+	}
+
+	TEST(Intrusive_list, erase_only)
+	{
+		Intrusive_list_node node;
+
+		Intrusive_counted_list list;
+		list.push_back(&node);
+		list.erase(&node);
+
+		check_order(list, {});
+		ASSERT_EQ(node.next(), nullptr);
+		ASSERT_EQ(node.prev(), nullptr);
+	}
+
+	TEST(Intrusive_list, insert_before_after)
+	{
+		std::vector<Intrusive_list_node> n(6);
+
+		Intrusive_counted_list list;
+		list.insert_before(nullptr, &n[2]);
+		check_order(list, {&n[2]});
+
+		list.insert_before(&n[2], &n[0]);
+		list.insert_after(&n[0], &n[1]);
+		list.insert_after(&n[2], &n[4]);
+		list.insert_before(&n[4], &n[3]);
+		list.insert_before(nullptr, &n[5]);
+
+		check_order(list, {&n[0], &n[1], &n[2], &n[3], &n[4], &n[5]});
+
+		list.erase(&n[0]);
+		list.erase(&n[5]);
+		list.erase(&n[3]);
+		check_order(list, {&n[1], &n[2], &n[4]});
+	}
+
+	TEST(Intrusive_list, splice_all)
+	{
+		std::vector<Intrusive_list_node> n(6);
+
+		Intrusive_counted_list list;
+		list.push_back(&n[0]);
+		list.push_back(&n[1]);
+
+		Intrusive_counted_list other;
+		other.push_back(&n[2]);
+		other.push_back(&n[3]);
+
+		list.splice(&n[1], other);
+		check_order(list, {&n[0], &n[2], &n[3], &n[1]});
+		check_order(other, {});
+
+		other.push_back(&n[4]);
+		other.push_back(&n[5]);
+		list.splice(nullptr, other);
+		check_order(list, {&n[0], &n[2], &n[3], &n[1], &n[4], &n[5]});
+
+		//into an empty list, and from an empty list
+		other.splice(nullptr, list);
+		check_order(other, {&n[0], &n[2], &n[3], &n[1], &n[4], &n[5]});
+		list.splice(nullptr, list);
+		check_order(list, {});
+	}
+
+	TEST(Intrusive_list, splice_range)
+	{
+		std::vector<Intrusive_list_node> n(8);
+
+		Intrusive_counted_list list;
+		list.push_back(&n[0]);
+		list.push_back(&n[1]);
+
+		Intrusive_counted_list other;
+		for(size_t i = 2; i < n.size(); i++)
+		{
+			other.push_back(&n[i]);
+		}
+
+		//middle of other to the middle of list
+		list.splice(&n[1], other, &n[3], &n[5]);
+		check_order(list, {&n[0], &n[3], &n[4], &n[1]});
+		check_order(other, {&n[2], &n[5], &n[6], &n[7]});
+
+		//tail of other to the end of list
+		list.splice(nullptr, other, &n[6], nullptr);
+		check_order(list, {&n[0], &n[3], &n[4], &n[1], &n[6], &n[7]});
+		check_order(other, {&n[2], &n[5]});
+
+		//head of other to the front of list
+		list.splice(&n[0], other, &n[2], &n[5]);
+		check_order(list, {&n[2], &n[0], &n[3], &n[4], &n[1], &n[6], &n[7]});
+		check_order(other, {&n[5]});
+
+		//empty range
+		list.splice(&n[0], other, &n[5], &n[5]);
+		check_order(other, {&n[5]});
+
+		//within the same list
+		list.splice(&n[2], list, &n[4], &n[6]);
+		check_order(list, {&n[4], &n[1], &n[2], &n[0], &n[3], &n[6], &n[7]});
+		list.splice(nullptr, list, &n[4], &n[2]);
+		check_order(list, {&n[2], &n[0], &n[3], &n[6], &n[7], &n[4], &n[1]});
+	}
+
+	TEST(Intrusive_list, splice_range_uncounted)
+	{
+		std::vector<Intrusive_list_node> n(4);
+
+		Intrusive_list list;
+		list.push_back(&n[0]);
+
+		Intrusive_list other;
+		other.push_back(&n[1]);
+		other.push_back(&n[2]);
+		other.push_back(&n[3]);
+
+		list.splice(nullptr, other, &n[1], &n[3]);
+		check_order(list, {&n[0], &n[1], &n[2]});
+		check_order(other, {&n[3]});
+	}
 }
\ No newline at end of file
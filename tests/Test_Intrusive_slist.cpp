@@ -3,6 +3,9 @@
 #include "gtest/gtest.h"
 #include "gmock/gmock.h"
 
+#include <cstdint>
+#include <vector>
+
 namespace
 {
 	TEST(Intrusive_slist, construct)
@@ -58,7 +61,6 @@ namespace
 			node = node->next();
 		}
 	}
-#if 0
 	TEST(Intrusive_slist, erase_last)
 	{
 		std::vector<Intrusive_slist_node> node_storage;
@@ -124,7 +126,6 @@ namespace
 		ASSERT_EQ(front, &(node_storage[1]));
 		ASSERT_EQ(front->next<Intrusive_slist_node>(), &(node_storage[0]));
 	}
-#endif
 	TEST(Intrusive_slist, pop_front)
 	{
 		std::vector<Intrusive_slist_node> node_storage;
@@ -506,4 +507,201 @@ namespace
 		}
 	}
 #endif
+
+	struct Intrusive_slist_job : public Intrusive_slist_node
+	{
+		uint32_t key;
+		uint32_t seq;
+	};
+
+	struct Intrusive_slist_job_lt
+	{
+		bool operator()(const Intrusive_slist_job& lhs, const Intrusive_slist_job& rhs) const
+		{
+			return lhs.key < rhs.key;
+		}
+	};
+
+	//sorted by key, equal keys in seq order, and every node still linked
+	void check_sorted(const Intrusive_slist& list, const size_t expected_size)
+	{
+		typedef Intrusive_slist_job Job;
+
+		size_t count = 0;
+		const Job* node = list.front<Job>();
+		while(node)
+		{
+			const Job* next = node->next<Job>();
+			if(next)
+			{
+				ASSERT_LE(node->key, next->key);
+				if(node->key == next->key)
+				{
+					ASSERT_LT(node->seq, next->seq);
+				}
+			}
+
+			count++;
+			node = next;
+		}
+		ASSERT_EQ(count, expected_size);
+	}
+
+	std::vector<Intrusive_slist_job> make_jobs(const size_t n, const uint32_t mod, uint32_t seed)
+	{
+		std::vector<Intrusive_slist_job> jobs(n);
+		for(size_t i = 0; i < n; i++)
+		{
+			seed = seed * 1103515245U + 12345U;
+			jobs[i].key = (seed >> 16) % mod;
+			jobs[i].seq = uint32_t(i);
+		}
+		return jobs;
+	}
+
+	TEST(Intrusive_slist, sort)
+	{
+		for(size_t n : {0, 1, 2, 3, 7, 16, 100, 1000})
+		{
+			std::vector<Intrusive_slist_job> jobs = make_jobs(n, 10, uint32_t(n));
+
+			Intrusive_slist list;
+			for(size_t i = jobs.size(); i > 0; i--)
+			{
+				list.push_front(&(jobs[i - 1]));
+			}
+
+			list.sort<Intrusive_slist_job>(Intrusive_slist_job_lt());
+			check_sorted(list, n);
+		}
+	}
+
+	TEST(Intrusive_slist, sort_presorted_and_reversed)
+	{
+		std::vector<Intrusive_slist_job> jobs(257);
+		for(size_t i = 0; i < jobs.size(); i++)
+		{
+			jobs[i].key = uint32_t(i);
+			jobs[i].seq = uint32_t(i);
+		}
+
+		Intrusive_slist list;
+		for(size_t i = jobs.size(); i > 0; i--)
+		{
+			list.push_front(&(jobs[i - 1]));
+		}
+
+		list.sort<Intrusive_slist_job>(Intrusive_slist_job_lt());
+		check_sorted(list, jobs.size());
+
+		list.sort<Intrusive_slist_job>([](const Intrusive_slist_job& lhs, const Intrusive_slist_job& rhs) { return lhs.key > rhs.key; });
+		ASSERT_EQ(list.front<Intrusive_slist_job>(), &(jobs.back()));
+
+		list.sort<Intrusive_slist_job>(Intrusive_slist_job_lt());
+		check_sorted(list, jobs.size());
+	}
+
+	TEST(Intrusive_slist, merge)
+	{
+		std::vector<Intrusive_slist_job> jobs = make_jobs(50, 20, 1);
+		std::vector<Intrusive_slist_job> jobs_b = make_jobs(70, 20, 2);
+		for(size_t i = 0; i < jobs_b.size(); i++)
+		{
+			jobs_b[i].seq += 1000;
+		}
+
+		Intrusive_slist list;
+		for(size_t i = jobs.size(); i > 0; i--)
+		{
+			list.push_front(&(jobs[i - 1]));
+		}
+		list.sort<Intrusive_slist_job>(Intrusive_slist_job_lt());
+
+		Intrusive_slist other;
+		for(size_t i = jobs_b.size(); i > 0; i--)
+		{
+			other.push_front(&(jobs_b[i - 1]));
+		}
+		other.sort<Intrusive_slist_job>(Intrusive_slist_job_lt());
+
+		list.merge<Intrusive_slist_job>(other, Intrusive_slist_job_lt());
+
+		ASSERT_TRUE(other.empty());
+		check_sorted(list, jobs.size() + jobs_b.size());
+
+		//merging into or from an empty list
+		Intrusive_slist empty;
+		list.merge<Intrusive_slist_job>(empty, Intrusive_slist_job_lt());
+		check_sorted(list, jobs.size() + jobs_b.size());
+
+		empty.merge<Intrusive_slist_job>(list, Intrusive_slist_job_lt());
+		ASSERT_TRUE(list.empty());
+		check_sorted(empty, jobs.size() + jobs_b.size());
+	}
+
+	//the default keeps the two pointer layout
+	static_assert(sizeof(Intrusive_slist) == sizeof(void*), "");
+	static_assert(sizeof(Intrusive_counted_slist) == sizeof(Intrusive_slist) + sizeof(size_t), "");
+
+	TEST(Intrusive_slist, erase_missing)
+	{
+		std::vector<Intrusive_slist_node> node_storage;
+		node_storage.resize(4);
+
+		Intrusive_slist slist;
+		for(size_t i = 0; i < 3; i++)
+		{
+			slist.push_front(&(node_storage[i]));
+		}
+
+		ASSERT_FALSE(slist.erase(&(node_storage[3])));
+		ASSERT_EQ(slist.size(), 3);
+
+		Intrusive_slist empty;
+		ASSERT_FALSE(empty.erase(&(node_storage[3])));
+	}
+
+	TEST(Intrusive_slist, counted_size)
+	{
+		std::vector<Intrusive_slist_node> node_storage;
+		node_storage.resize(8);
+
+		Intrusive_counted_slist list;
+		ASSERT_EQ(list.size(), 0U);
+		for(size_t i = 0; i < node_storage.size(); i++)
+		{
+			list.push_front(&(node_storage[i]));
+			ASSERT_EQ(list.size(), i + 1);
+		}
+
+		list.pop_front();
+		ASSERT_EQ(list.size(), 7U);
+
+		ASSERT_TRUE(list.erase(&(node_storage[3])));
+		ASSERT_EQ(list.size(), 6U);
+
+		//not in the list
+		ASSERT_FALSE(list.erase(&(node_storage[3])));
+		ASSERT_EQ(list.size(), 6U);
+
+		Intrusive_counted_slist moved(std::move(list));
+		ASSERT_EQ(list.size(), 0U);
+		ASSERT_EQ(moved.size(), 6U);
+
+		Intrusive_counted_slist other;
+		other.push_front(&(node_storage[3]));
+		other.push_front(&(node_storage[7]));
+		moved.merge<Intrusive_slist_node>(other, [](const Intrusive_slist_node& lhs, const Intrusive_slist_node& rhs) { return &lhs < &rhs; });
+		ASSERT_EQ(other.size(), 0U);
+		ASSERT_EQ(moved.size(), 8U);
+
+		while(!moved.empty())
+		{
+			moved.pop_front();
+		}
+		ASSERT_EQ(moved.size(), 0U);
+
+		moved.pop_front();
+		ASSERT_EQ(moved.size(), 0U);
+	}
 }
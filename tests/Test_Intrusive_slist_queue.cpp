@@ -0,0 +1,170 @@
+#include "common_util/Intrusive_slist_queue.hpp"
+
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+
+#include <vector>
+
+namespace
+{
+	//one pointer per node, two for the queue
+	static_assert(sizeof(Intrusive_slist_node) == sizeof(void*), "");
+	static_assert(sizeof(Intrusive_slist_queue) == 2 * sizeof(void*), "");
+
+	template<typename Queue>
+	void check_order(const Queue& queue, const std::vector<Intrusive_slist_node*>& expected)
+	{
+		ASSERT_EQ(queue.size(), expected.size());
+		ASSERT_EQ(queue.empty(), expected.empty());
+
+		const Intrusive_slist_node* node = queue.template front<Intrusive_slist_node>();
+		for(size_t i = 0; i < expected.size(); i++)
+		{
+			ASSERT_EQ(node, expected[i]);
+			node = node->next();
+		}
+		ASSERT_EQ(node, nullptr);
+
+		if(expected.empty())
+		{
+			ASSERT_EQ(queue.template back<Intrusive_slist_node>(), nullptr);
+		}
+		else
+		{
+			ASSERT_EQ(queue.template back<Intrusive_slist_node>(), expected.back());
+		}
+	}
+
+	TEST(Intrusive_slist_queue, empty)
+	{
+		Intrusive_slist_queue queue;
+		check_order(queue, {});
+
+		queue.pop_front();
+		check_order(queue, {});
+	}
+
+	TEST(Intrusive_slist_queue, fifo)
+	{
+		std::vector<Intrusive_slist_node> n(4);
+
+		Intrusive_counted_slist_queue queue;
+		for(size_t i = 0; i < n.size(); i++)
+		{
+			queue.push_back(&n[i]);
+		}
+		check_order(queue, {&n[0], &n[1], &n[2], &n[3]});
+
+		queue.pop_front();
+		queue.pop_front();
+		check_order(queue, {&n[2], &n[3]});
+
+		queue.push_back(&n[0]);
+		check_order(queue, {&n[2], &n[3], &n[0]});
+
+		queue.pop_front();
+		queue.pop_front();
+		queue.pop_front();
+		check_order(queue, {});
+
+		//the tail is reset when the queue drains
+		queue.push_back(&n[1]);
+		check_order(queue, {&n[1]});
+	}
+
+	TEST(Intrusive_slist_queue, push_front)
+	{
+		std::vector<Intrusive_slist_node> n(3);
+
+		Intrusive_counted_slist_queue queue;
+		queue.push_front(&n[1]);
+		check_order(queue, {&n[1]});
+
+		queue.push_front(&n[0]);
+		queue.push_back(&n[2]);
+		check_order(queue, {&n[0], &n[1], &n[2]});
+	}
+
+	TEST(Intrusive_slist_queue, splice_back)
+	{
+		std::vector<Intrusive_slist_node> n(5);
+
+		Intrusive_counted_slist_queue queue;
+		Intrusive_counted_slist_queue other;
+
+		other.push_back(&n[0]);
+		queue.splice_back(other);
+		check_order(queue, {&n[0]});
+		check_order(other, {});
+
+		other.push_back(&n[1]);
+		other.push_back(&n[2]);
+		queue.splice_back(other);
+		check_order(queue, {&n[0], &n[1], &n[2]});
+		check_order(other, {});
+
+		queue.splice_back(other);
+		queue.splice_back(queue);
+		check_order(queue, {&n[0], &n[1], &n[2]});
+
+		//appending after a splice uses the new tail
+		queue.push_back(&n[3]);
+		check_order(queue, {&n[0], &n[1], &n[2], &n[3]});
+
+		Intrusive_counted_slist_queue moved(std::move(queue));
+		check_order(queue, {});
+		check_order(moved, {&n[0], &n[1], &n[2], &n[3]});
+	}
+
+	TEST(Intrusive_slist_queue, erase_after)
+	{
+		std::vector<Intrusive_slist_node> n(4);
+
+		Intrusive_counted_slist_queue queue;
+		for(size_t i = 0; i < n.size(); i++)
+		{
+			queue.push_back(&n[i]);
+		}
+
+		ASSERT_EQ(queue.erase_after(&n[1]), &n[2]);
+		ASSERT_EQ(n[2].next(), nullptr);
+		check_order(queue, {&n[0], &n[1], &n[3]});
+
+		//erasing the back moves the tail
+		ASSERT_EQ(queue.erase_after(&n[1]), &n[3]);
+		check_order(queue, {&n[0], &n[1]});
+
+		ASSERT_EQ(queue.erase_after(&n[1]), nullptr);
+		check_order(queue, {&n[0], &n[1]});
+
+		queue.push_back(&n[2]);
+		check_order(queue, {&n[0], &n[1], &n[2]});
+	}
+
+	TEST(Intrusive_slist_queue, iterator)
+	{
+		std::vector<Intrusive_slist_node> n(3);
+
+		Intrusive_slist_queue queue;
+		for(size_t i = 0; i < n.size(); i++)
+		{
+			queue.push_back(&n[i]);
+		}
+
+		size_t i = 0;
+		for(Intrusive_slist_node& node : queue)
+		{
+			ASSERT_EQ(&node, &n[i]);
+			i++;
+		}
+		ASSERT_EQ(i, 3U);
+
+		i = 0;
+		for(auto itr = queue.cbegin(); itr != queue.cend(); itr++)
+		{
+			ASSERT_EQ(&(*itr), &n[i]);
+			i++;
+		}
+		ASSERT_EQ(i, 3U);
+	}
+}
@@ -0,0 +1,129 @@
+#include "common_util/Network_sort.hpp"
+#include "common_util/Insertion_sort.hpp"
+
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+
+#include <algorithm>
+#include <array>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace
+{
+	static_assert(Sort_network<2>::type::SIZE == 1, "");
+	static_assert(Sort_network<3>::type::SIZE == 3, "");
+	static_assert(Sort_network<4>::type::SIZE == 5, "");
+	static_assert(Sort_network<5>::type::SIZE == 9, "");
+	static_assert(Sort_network<6>::type::SIZE == 12, "");
+	static_assert(Sort_network<7>::type::SIZE == 16, "");
+	static_assert(Sort_network<8>::type::SIZE == 19, "");
+	static_assert(Sort_network<16>::type::SIZE == 60, "");
+
+	//0-1 principle, a network sorts everything iff it sorts every sequence of 0 and 1
+	template<size_t N>
+	void check_zero_one()
+	{
+		for(uint32_t bits = 0; bits < (uint32_t(1) << N); bits++)
+		{
+			std::array<uint8_t, N> v;
+			for(size_t i = 0; i < N; i++)
+			{
+				v[i] = (bits >> i) & 1U;
+			}
+
+			network_sort<N>(v.begin());
+			ASSERT_TRUE(std::is_sorted(v.begin(), v.end())) << "N " << N << " bits " << bits;
+		}
+	}
+
+	TEST(Network_sort, zero_one_tables)
+	{
+		check_zero_one<2>();
+		check_zero_one<3>();
+		check_zero_one<4>();
+		check_zero_one<5>();
+		check_zero_one<6>();
+		check_zero_one<7>();
+		check_zero_one<8>();
+		check_zero_one<16>();
+	}
+
+	TEST(Network_sort, zero_one_batcher)
+	{
+		check_zero_one<1>();
+		check_zero_one<9>();
+		check_zero_one<10>();
+		check_zero_one<11>();
+		check_zero_one<12>();
+		check_zero_one<13>();
+		check_zero_one<14>();
+		check_zero_one<15>();
+		check_zero_one<17>();
+		check_zero_one<20>();
+	}
+
+	TEST(Network_sort, kernels)
+	{
+		std::array<float, 8> f = {3.5f, -1.0f, 2.0f, 8.0f, 0.0f, -7.5f, 2.0f, 1.0f};
+		network_sort<8>(f.begin());
+		EXPECT_THAT(f, ::testing::ElementsAre(-7.5f, -1.0f, 0.0f, 1.0f, 2.0f, 2.0f, 3.5f, 8.0f));
+
+		std::array<int, 5> g = {1, 5, 2, 4, 3};
+		network_sort<5>(g.begin(), std::greater<int>());
+		EXPECT_THAT(g, ::testing::ElementsAre(5, 4, 3, 2, 1));
+
+		//trivially copyable struct with a custom comparator
+		struct Level
+		{
+			int price;
+			int qty;
+		};
+		std::array<Level, 4> levels = {{{30, 1}, {10, 2}, {40, 3}, {20, 4}}};
+		network_sort<4>(levels.begin(), [](const Level& a, const Level& b){ return a.price < b.price; });
+		EXPECT_EQ(levels[0].qty, 2);
+		EXPECT_EQ(levels[1].qty, 4);
+		EXPECT_EQ(levels[2].qty, 1);
+		EXPECT_EQ(levels[3].qty, 3);
+
+		std::array<std::string, 3> s = {"c", "a", "b"};
+		network_sort<3>(s.begin());
+		EXPECT_THAT(s, ::testing::ElementsAre("a", "b", "c"));
+	}
+
+	TEST(Network_sort, insertion_sort_fixed)
+	{
+		std::array<int, 16> a;
+		for(size_t i = 0; i < a.size(); i++)
+		{
+			a[i] = int((i * 7) % 16);
+		}
+		insertion_sort(a);
+		EXPECT_TRUE(std::is_sorted(a.begin(), a.end()));
+
+		insertion_sort(a, std::greater<int>());
+		EXPECT_TRUE(std::is_sorted(a.begin(), a.end(), std::greater<int>()));
+
+		uint16_t c[3] = {3, 1, 2};
+		insertion_sort(c);
+		EXPECT_THAT(c, ::testing::ElementsAre(1, 2, 3));
+
+		//still the iterator form
+		insertion_sort(c, c + 3, std::greater<uint16_t>());
+		EXPECT_THAT(c, ::testing::ElementsAre(3, 2, 1));
+
+		//too big or a custom comparator stays a stable insertion sort
+		std::array< std::pair<int, int>, 4 > p = {{{2, 0}, {1, 1}, {2, 2}, {1, 3}}};
+		insertion_sort(p, [](const std::pair<int, int>& l, const std::pair<int, int>& r){ return l.first < r.first; });
+		EXPECT_THAT(p, ::testing::ElementsAre(std::make_pair(1, 1), std::make_pair(1, 3), std::make_pair(2, 0), std::make_pair(2, 2)));
+
+		std::array<int, 40> big;
+		for(size_t i = 0; i < big.size(); i++)
+		{
+			big[i] = int(big.size() - i);
+		}
+		insertion_sort(big);
+		EXPECT_TRUE(std::is_sorted(big.begin(), big.end()));
+	}
+}
@@ -0,0 +1,141 @@
+#include "common_util/Parallel_sort.hpp"
+
+#include "Test_util.hpp"
+
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace
+{
+	void check_sort(std::vector<uint32_t> v, const size_t num_threads)
+	{
+		std::vector<uint32_t> expected = v;
+		std::sort(expected.begin(), expected.end());
+
+		parallel_sort(v.begin(), v.end(), std::less<uint32_t>(), num_threads);
+		EXPECT_EQ(expected, v) << "n " << v.size() << " threads " << num_threads;
+	}
+
+	struct Sort_error
+	{
+
+	};
+
+	//throws when it sees the poison value
+	struct Poison_less
+	{
+		bool operator()(const uint32_t lhs, const uint32_t rhs) const
+		{
+			if((lhs == poison) || (rhs == poison))
+			{
+				throw Sort_error();
+			}
+			return lhs < rhs;
+		}
+
+		uint32_t poison;
+	};
+
+	TEST(Parallel_sort, comparator_throws)
+	{
+		const size_t n = 8 * PARALLEL_SORT_MIN_CHUNK;
+
+		//the first chunk is sorted on the calling thread, the last on a worker
+		for(const size_t poison_idx : {size_t(0), n - 1})
+		{
+			std::vector<uint32_t> v = make_random(n, 1000, 5);
+			v[poison_idx] = 1000;
+
+			EXPECT_THROW(parallel_sort(v.begin(), v.end(), Poison_less{1000}, 4), Sort_error) << "poison at " << poison_idx;
+		}
+	}
+
+	TEST(Parallel_sort, small_is_sequential)
+	{
+		for(size_t n : {size_t(0), size_t(1), size_t(2), size_t(17), size_t(1000), 2 * PARALLEL_SORT_MIN_CHUNK - 1})
+		{
+			check_sort(make_random(n, 0, uint32_t(n)), 8);
+		}
+	}
+
+	TEST(Parallel_sort, random)
+	{
+		for(size_t num_threads : {1, 2, 3, 4, 7, 8})
+		{
+			check_sort(make_random(200000, 0, uint32_t(num_threads)), num_threads);
+		}
+	}
+
+	TEST(Parallel_sort, default_threads)
+	{
+		std::vector<uint32_t> v = make_random(100000, 0, 9);
+		std::vector<uint32_t> expected = v;
+		std::sort(expected.begin(), expected.end());
+
+		parallel_sort(v.begin(), v.end());
+		EXPECT_EQ(expected, v);
+	}
+
+	TEST(Parallel_sort, duplicates_and_patterns)
+	{
+		check_sort(make_random(150000, 4, 1), 4);
+		check_sort(std::vector<uint32_t>(150000, 7), 4);
+
+		std::vector<uint32_t> sorted(150000);
+		for(size_t i = 0; i < sorted.size(); i++)
+		{
+			sorted[i] = uint32_t(i);
+		}
+		check_sort(sorted, 5);
+
+		std::vector<uint32_t> reversed(sorted.rbegin(), sorted.rend());
+		check_sort(reversed, 5);
+	}
+
+	TEST(Parallel_sort, move_only_greater)
+	{
+		const std::vector<uint32_t> keys = make_random(100000, 1000, 3);
+
+		std::vector< std::unique_ptr<uint32_t> > v;
+		for(uint32_t k : keys)
+		{
+			v.emplace_back(new uint32_t(k));
+		}
+
+		parallel_sort(v.begin(), v.end(), [](const std::unique_ptr<uint32_t>& lhs, const std::unique_ptr<uint32_t>& rhs)
+		{
+			return *lhs > *rhs;
+		}, 4);
+
+		std::vector<uint32_t> expected = keys;
+		std::sort(expected.begin(), expected.end(), std::greater<uint32_t>());
+		for(size_t i = 0; i < v.size(); i++)
+		{
+			ASSERT_EQ(expected[i], *v[i]);
+		}
+	}
+
+	TEST(Parallel_sort, strings)
+	{
+		const std::vector<uint32_t> keys = make_random(50000, 0, 4);
+
+		std::vector<std::string> v;
+		for(uint32_t k : keys)
+		{
+			v.push_back(std::to_string(k));
+		}
+
+		std::vector<std::string> expected = v;
+		std::sort(expected.begin(), expected.end());
+
+		parallel_sort(v.begin(), v.end(), std::less<std::string>(), 3);
+		EXPECT_EQ(expected, v);
+	}
+}
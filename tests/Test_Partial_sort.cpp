@@ -0,0 +1,174 @@
+#include "common_util/Partial_sort.hpp"
+
+#include "Test_util.hpp"
+
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace
+{
+	std::vector< std::vector<uint32_t> > make_inputs(const size_t n)
+	{
+		std::vector< std::vector<uint32_t> > inputs;
+		inputs.push_back(make_random(n, 0, uint32_t(n)));
+		inputs.push_back(make_random(n, 5, uint32_t(n + 1)));
+
+		std::vector<uint32_t> sorted(n);
+		for(size_t i = 0; i < n; i++)
+		{
+			sorted[i] = uint32_t(i);
+		}
+		inputs.push_back(sorted);
+		inputs.push_back(std::vector<uint32_t>(sorted.rbegin(), sorted.rend()));
+
+		//organ pipe
+		std::vector<uint32_t> pipe(n);
+		for(size_t i = 0; i < n; i++)
+		{
+			pipe[i] = uint32_t(std::min(i, n - i));
+		}
+		inputs.push_back(pipe);
+
+		return inputs;
+	}
+
+	template<class Fn>
+	void check_partial(Fn fn)
+	{
+		for(size_t n : {0, 1, 2, 10, 100, 1000})
+		{
+			for(const std::vector<uint32_t>& input : make_inputs(n))
+			{
+				for(size_t k : {size_t(0), size_t(1), size_t(3), n / 2, n})
+				{
+					if(k > n)
+					{
+						continue;
+					}
+
+					std::vector<uint32_t> expected = input;
+					std::sort(expected.begin(), expected.end());
+
+					std::vector<uint32_t> v = input;
+					fn(v.begin(), v.begin() + k, v.end());
+
+					ASSERT_TRUE(std::equal(v.begin(), v.begin() + k, expected.begin())) << "n " << n << " k " << k;
+					std::sort(v.begin(), v.end());
+					ASSERT_EQ(expected, v);
+				}
+			}
+		}
+	}
+
+	TEST(Partial_sort, partial_insertion_sort)
+	{
+		check_partial([](std::vector<uint32_t>::iterator b, std::vector<uint32_t>::iterator m, std::vector<uint32_t>::iterator e)
+		{
+			partial_insertion_sort(b, m, e);
+		});
+	}
+
+	TEST(Partial_sort, partial_heap_sort)
+	{
+		check_partial([](std::vector<uint32_t>::iterator b, std::vector<uint32_t>::iterator m, std::vector<uint32_t>::iterator e)
+		{
+			partial_heap_sort(b, m, e);
+		});
+	}
+
+	TEST(Partial_sort, intro_select)
+	{
+		for(size_t n : {1, 2, 10, 17, 100, 1000, 10000})
+		{
+			for(const std::vector<uint32_t>& input : make_inputs(n))
+			{
+				std::vector<uint32_t> expected = input;
+				std::sort(expected.begin(), expected.end());
+
+				for(size_t nth : {size_t(0), size_t(1), n / 3, n / 2, n - 1})
+				{
+					if(nth >= n)
+					{
+						continue;
+					}
+
+					std::vector<uint32_t> v = input;
+					intro_select(v.begin(), v.begin() + nth, v.end());
+
+					ASSERT_EQ(expected[nth], v[nth]) << "n " << n << " nth " << nth;
+					for(size_t i = 0; i < nth; i++)
+					{
+						ASSERT_LE(v[i], v[nth]);
+					}
+					for(size_t i = nth + 1; i < n; i++)
+					{
+						ASSERT_GE(v[i], v[nth]);
+					}
+				}
+			}
+		}
+	}
+
+	TEST(Partial_sort, intro_select_greater)
+	{
+		std::vector<uint32_t> v = make_random(5000, 0, 7);
+		std::vector<uint32_t> expected = v;
+		std::sort(expected.begin(), expected.end(), std::greater<uint32_t>());
+
+		intro_select(v.begin(), v.begin() + 9, v.end(), std::greater<uint32_t>());
+		EXPECT_EQ(expected[9], v[9]);
+	}
+
+	TEST(Partial_sort, top_k)
+	{
+		const std::vector<uint32_t> input = make_random(10000, 100000, 3);
+
+		Top_k<uint32_t, 10, std::greater<uint32_t>> slowest;
+		EXPECT_TRUE(slowest.empty());
+		EXPECT_EQ(10U, slowest.capacity());
+
+		slowest.push(input.begin(), input.end());
+		EXPECT_TRUE(slowest.full());
+		ASSERT_EQ(10U, slowest.size());
+
+		std::vector<uint32_t> expected = input;
+		std::sort(expected.begin(), expected.end(), std::greater<uint32_t>());
+
+		//the bar to get in is the 10th largest
+		EXPECT_EQ(expected[9], slowest.top());
+
+		std::array<uint32_t, 10> out;
+		EXPECT_EQ(10U, slowest.get_sorted(out.data()));
+		EXPECT_TRUE(std::equal(out.begin(), out.end(), expected.begin()));
+
+		EXPECT_FALSE(slowest.push(0));
+		EXPECT_TRUE(slowest.push(200000));
+		EXPECT_EQ(expected[8], slowest.top());
+
+		slowest.clear();
+		EXPECT_TRUE(slowest.empty());
+	}
+
+	TEST(Partial_sort, top_k_partial_fill)
+	{
+		Top_k<int, 8> smallest;
+		for(int x : {5, 3, 9, 1})
+		{
+			EXPECT_TRUE(smallest.push(x));
+		}
+		EXPECT_EQ(4U, smallest.size());
+		EXPECT_EQ(9, smallest.top());
+
+		std::array<int, 8> out;
+		ASSERT_EQ(4U, smallest.get_sorted(out.data()));
+		EXPECT_EQ(1, out[0]);
+		EXPECT_EQ(3, out[1]);
+		EXPECT_EQ(5, out[2]);
+		EXPECT_EQ(9, out[3]);
+	}
+}
@@ -0,0 +1,173 @@
+#include "common_util/Radix_sort.hpp"
+
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace
+{
+	uint64_t next_random(uint64_t* const state)
+	{
+		*state = *state * 6364136223846793005ULL + 1442695040888963407ULL;
+		return *state >> 11;
+	}
+
+	template<typename T>
+	std::vector<T> make_random(const size_t n, const uint64_t mod, uint64_t seed)
+	{
+		std::vector<T> v(n);
+		for(size_t i = 0; i < n; i++)
+		{
+			const uint64_t r = next_random(&seed) ^ (next_random(&seed) << 21);
+			v[i] = T((mod == 0) ? r : (r % mod));
+		}
+		return v;
+	}
+
+	template<typename T>
+	void check_both(std::vector<T> v)
+	{
+		std::vector<T> expected = v;
+		std::sort(expected.begin(), expected.end());
+
+		std::vector<T> lsd = v;
+		std::vector<T> scratch(v.size());
+		radix_sort(lsd.data(), scratch.data(), lsd.size());
+		EXPECT_EQ(expected, lsd);
+
+		std::vector<T> msd = v;
+		radix_sort_in_place(msd.data(), msd.size());
+		EXPECT_EQ(expected, msd);
+	}
+
+	struct Record
+	{
+		int32_t key;
+		uint32_t seq;
+	};
+
+	struct Record_key
+	{
+		int32_t operator()(const Record& r) const
+		{
+			return r.key;
+		}
+	};
+
+	TEST(Radix_sort, get_b)
+	{
+		static_assert(Byte_util::get_b<0>(uint32_t(0x11223344)) == 0x44, "");
+		static_assert(Byte_util::get_b<3>(uint32_t(0x11223344)) == 0x11, "");
+		static_assert(Byte_util::get_b<7>(uint64_t(0x8877665544332211ULL)) == Byte_util::get_b7(uint64_t(0x8877665544332211ULL)), "");
+		static_assert(Byte_util::get_b<1>(uint16_t(0xABCD)) == 0xAB, "");
+	}
+
+	TEST(Radix_sort, small)
+	{
+		check_both(std::vector<uint32_t>());
+		check_both(std::vector<uint32_t>{5});
+		check_both(std::vector<uint32_t>{5, 1});
+		check_both(std::vector<uint8_t>{3, 255, 0, 7, 7, 1});
+	}
+
+	TEST(Radix_sort, unsigned_keys)
+	{
+		for(size_t n : {10, 100, 1000, 20000})
+		{
+			check_both(make_random<uint8_t>(n, 0, n));
+			check_both(make_random<uint16_t>(n, 0, n));
+			check_both(make_random<uint32_t>(n, 0, n));
+			check_both(make_random<uint64_t>(n, 0, n));
+		}
+	}
+
+	TEST(Radix_sort, signed_keys)
+	{
+		std::vector<int32_t> v = make_random<int32_t>(5000, 0, 1);
+		v.push_back(std::numeric_limits<int32_t>::min());
+		v.push_back(std::numeric_limits<int32_t>::max());
+		v.push_back(0);
+		v.push_back(-1);
+		check_both(v);
+
+		check_both(make_random<int64_t>(5000, 0, 2));
+		check_both(make_random<int8_t>(5000, 0, 3));
+	}
+
+	TEST(Radix_sort, duplicates_and_skipped_passes)
+	{
+		//only the low byte differs, the upper passes are skipped
+		check_both(make_random<uint32_t>(5000, 200, 4));
+		check_both(make_random<uint64_t>(5000, 3, 5));
+		check_both(std::vector<uint64_t>(1000, 0x0123456789ABCDEFULL));
+
+		std::vector<uint32_t> sorted(5000);
+		for(size_t i = 0; i < sorted.size(); i++)
+		{
+			sorted[i] = uint32_t(i) << 12;
+		}
+		check_both(sorted);
+
+		std::vector<uint32_t> reversed(sorted.rbegin(), sorted.rend());
+		check_both(reversed);
+	}
+
+	TEST(Radix_sort, key_fn_is_stable)
+	{
+		std::vector<int32_t> keys = make_random<int32_t>(10000, 100, 6);
+
+		std::vector<Record> v(keys.size());
+		for(size_t i = 0; i < v.size(); i++)
+		{
+			v[i].key = keys[i] - 50;
+			v[i].seq = uint32_t(i);
+		}
+
+		std::vector<Record> scratch(v.size());
+		radix_sort(v.data(), scratch.data(), v.size(), Record_key());
+
+		for(size_t i = 1; i < v.size(); i++)
+		{
+			ASSERT_LE(v[i - 1].key, v[i].key);
+			if(v[i - 1].key == v[i].key)
+			{
+				ASSERT_LT(v[i - 1].seq, v[i].seq);
+			}
+		}
+	}
+
+	TEST(Radix_sort, key_fn_in_place)
+	{
+		std::vector<int32_t> keys = make_random<int32_t>(10000, 0, 7);
+
+		std::vector<Record> v(keys.size());
+		for(size_t i = 0; i < v.size(); i++)
+		{
+			v[i].key = keys[i];
+			v[i].seq = uint32_t(i);
+		}
+
+		radix_sort_in_place(v.data(), v.size(), [](const Record& r) { return r.key; });
+
+		for(size_t i = 1; i < v.size(); i++)
+		{
+			ASSERT_LE(v[i - 1].key, v[i].key);
+		}
+
+		//still a permutation
+		std::vector<uint32_t> seqs(v.size());
+		for(size_t i = 0; i < v.size(); i++)
+		{
+			seqs[i] = v[i].seq;
+		}
+		std::sort(seqs.begin(), seqs.end());
+		for(size_t i = 0; i < seqs.size(); i++)
+		{
+			ASSERT_EQ(i, seqs[i]);
+		}
+	}
+}
@@ -0,0 +1,79 @@
+#include "common_util/Register_field.hpp"
+
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+
+namespace
+{
+	typedef Reg_field<0, 1>  EN;
+	typedef Reg_field<1, 2>  MODE;
+	typedef Reg_field<4, 4>  DIV;
+	typedef Reg_field<28, 4> TOP;
+
+	typedef Reg<uint32_t, EN, MODE, DIV, TOP> Ctrl_reg;
+
+	static_assert(EN::mask<uint32_t>() == 0x00000001, "");
+	static_assert(MODE::mask<uint32_t>() == 0x00000006, "");
+	static_assert(DIV::mask<uint32_t>() == 0x000000F0, "");
+	static_assert(TOP::mask<uint32_t>() == 0xF0000000, "");
+	static_assert(Reg_field<0, 64>::mask<uint64_t>() == ~uint64_t(0), "");
+
+	static_assert(Reg_field_set<uint32_t, EN, MODE, DIV>::mask() == 0xF7, "");
+	static_assert(Reg_field_set<uint32_t, EN, MODE>::disjoint(), "");
+	static_assert(!Reg_field_set<uint32_t, MODE, Reg_field<2, 3>>::disjoint(), "");
+	static_assert(!Reg_field_set<uint8_t, Reg_field<4, 5>>::fits(), "");
+	static_assert(Reg_field_set<uint32_t, DIV, EN>::subset_of<EN, MODE, DIV>(), "");
+	static_assert(!Reg_field_set<uint32_t, TOP>::subset_of<EN, MODE, DIV>(), "");
+
+	static_assert(Ctrl_reg::value<EN, MODE, DIV>(1, 3, 7) == 0x77, "");
+	static_assert(Ctrl_reg::value<DIV, EN>(0xFF, 1) == 0xF1, "");
+
+	TEST(Register_field, write)
+	{
+		volatile uint32_t reg = 0xA5A5A5A5;
+		Ctrl_reg ctrl(&reg);
+
+		ctrl.write<EN, MODE, DIV>(0, 1, 0xC);
+		EXPECT_EQ(reg, 0xA5A5A5C2);
+
+		ctrl.write<TOP>(0x3);
+		EXPECT_EQ(reg, 0x35A5A5C2);
+
+		EXPECT_EQ(ctrl.read<EN>(), 0);
+		EXPECT_EQ(ctrl.read<MODE>(), 1);
+		EXPECT_EQ(ctrl.read<DIV>(), 0xC);
+		EXPECT_EQ(ctrl.read<TOP>(), 0x3);
+		EXPECT_EQ(ctrl.read_raw(), 0x35A5A5C2);
+	}
+
+	TEST(Register_field, matches_mask_set_bits)
+	{
+		volatile uint32_t reg = 0x12345678;
+		volatile uint32_t ref = 0x12345678;
+		Ctrl_reg ctrl(&reg);
+
+		ctrl.write<MODE, DIV>(2, 9);
+		Register_util::mask_set_bits<uint32_t>(&ref, 0x6, 2 << 1);
+		Register_util::mask_set_bits<uint32_t>(&ref, 0xF0, 9 << 4);
+
+		EXPECT_EQ(reg, ref);
+	}
+
+	TEST(Register_field, overwrite)
+	{
+		volatile uint32_t reg = 0xFFFFFFFF;
+		Ctrl_reg ctrl(&reg);
+
+		ctrl.overwrite<EN, DIV>(1, 5);
+		EXPECT_EQ(reg, 0x00000051);
+	}
+
+	TEST(Register_field, value_truncated_to_field)
+	{
+		volatile uint8_t reg = 0;
+		Reg<uint8_t, Reg_field<2, 3>> small(&reg);
+
+		small.write<Reg_field<2, 3>>(0xFF);
+		EXPECT_EQ(reg, 0x1C);
+	}
+}
@@ -0,0 +1,200 @@
+#include "common_util/Register_trace.hpp"
+#include "common_util/Sim_register.hpp"
+#include "common_util/Stack_string.hpp"
+
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+
+#include <thread>
+#include <vector>
+
+namespace
+{
+	class Count_timestamp
+	{
+	public:
+		static uint32_t now()
+		{
+			return ++ticks;
+		}
+
+		static uint32_t ticks;
+	};
+
+	uint32_t Count_timestamp::ticks = 0;
+
+	typedef Register_trace_buffer<8, Count_timestamp> Trace_buffer;
+	Trace_buffer g_trace;
+
+	typedef Register_util_base< Register_trace_to_buffer<Trace_buffer, &g_trace> > Traced_util;
+
+	TEST(Register_trace, records_ops)
+	{
+		g_trace.clear();
+		Count_timestamp::ticks = 0;
+
+		Sim_register<uint32_t> reg;
+		reg.poke(0xF0);
+
+		Traced_util::set_bits<uint32_t>(&reg, 0x1);
+		Traced_util::clear_bits<uint32_t>(&reg, 0x10);
+		Traced_util::mask_set_bits<uint32_t>(&reg, 0xF, 0x4);
+
+		reg.set_bits_after_reads(2, 0x100);
+		Traced_util::wait_until_set<uint32_t>(&reg, 0x100);
+		EXPECT_FALSE(Traced_util::wait_until_clear<uint32_t>(&reg, 0x100, Spin_budget(3)));
+
+		reg.clear_bits_after_reads(1, 0x100);
+		EXPECT_TRUE(Traced_util::wait_until_clear<uint32_t>(&reg, 0x100, Spin_budget(3)));
+		EXPECT_TRUE(Traced_util::wait_until_value<uint32_t>(&reg, 0xF, 0x4, Spin_budget(3)));
+
+		std::array<Register_trace_record, 8> recs;
+		ASSERT_EQ(g_trace.snapshot(recs.data(), recs.size()), 7);
+
+		EXPECT_EQ(recs[0].op, Register_op::SET_BITS);
+		EXPECT_EQ(recs[0].addr, reinterpret_cast<uintptr_t>(&reg));
+		EXPECT_EQ(recs[0].old_val, 0xF0);
+		EXPECT_EQ(recs[0].new_val, 0xF1);
+		EXPECT_EQ(recs[0].timestamp, 1);
+
+		EXPECT_EQ(recs[1].op, Register_op::CLEAR_BITS);
+		EXPECT_EQ(recs[1].new_val, 0xE1);
+
+		EXPECT_EQ(recs[2].op, Register_op::MASK_SET_BITS);
+		EXPECT_EQ(recs[2].old_val, 0xE1);
+		EXPECT_EQ(recs[2].new_val, 0xE4);
+
+		EXPECT_EQ(recs[3].op, Register_op::WAIT_SET);
+		EXPECT_EQ(recs[3].old_val, 0xE4);
+		EXPECT_EQ(recs[3].new_val, 0x1E4);
+
+		EXPECT_EQ(recs[4].op, Register_op::WAIT_TIMEOUT);
+		EXPECT_EQ(recs[4].seq, 4);
+
+		EXPECT_EQ(recs[5].op, Register_op::WAIT_CLEAR);
+		EXPECT_EQ(recs[5].new_val, 0xE4);
+
+		EXPECT_EQ(recs[6].op, Register_op::WAIT_VALUE);
+	}
+
+	TEST(Register_trace, ring_keeps_latest)
+	{
+		g_trace.clear();
+
+		volatile uint32_t reg = 0;
+		for(uint32_t i = 0; i < 20; i++)
+		{
+			Traced_util::mask_set_bits<uint32_t>(&reg, 0xFF, i);
+		}
+		EXPECT_EQ(g_trace.total(), 20);
+
+		std::array<Register_trace_record, 8> recs;
+		ASSERT_EQ(g_trace.snapshot(recs.data(), recs.size()), 8);
+		for(size_t i = 0; i < recs.size(); i++)
+		{
+			EXPECT_EQ(recs[i].seq, 12 + i);
+			EXPECT_EQ(recs[i].new_val, 12 + i);
+		}
+
+		//only the newest
+		ASSERT_EQ(g_trace.snapshot(recs.data(), 2), 2);
+		EXPECT_EQ(recs[0].seq, 18);
+		EXPECT_EQ(recs[1].seq, 19);
+	}
+
+	TEST(Register_trace, decode)
+	{
+		Register_trace_record rec;
+		rec.seq = 0x12;
+		rec.timestamp = 0xABCD;
+		rec.addr = 0x40001000;
+		rec.old_val = 0x10;
+		rec.new_val = 0x30;
+		rec.op = Register_op::MASK_SET_BITS;
+
+		Stack_string<128> str;
+		ASSERT_TRUE(Register_trace_decoder::format(rec, &str));
+		EXPECT_STREQ(str.c_str(), "00000012 0000ABCD MASK_SET_BITS 0000000040001000 0000000000000010 -> 0000000000000030\n");
+		EXPECT_LE(str.size(), Register_trace_decoder::MAX_LINE_LEN);
+
+		Stack_string<32> small;
+		EXPECT_FALSE(Register_trace_decoder::format(rec, &small));
+		EXPECT_TRUE(small.empty());
+	}
+
+	//exposes a slot to stand in for a writer that was preempted partway through a record
+	class Stalled_trace : public Register_trace_buffer<4>
+	{
+	public:
+		void stall_slot(const size_t idx)
+		{
+			m_slots[idx].stamp.store(STAMP_BUSY);
+		}
+	};
+
+	TEST(Register_trace, busy_slot_drops)
+	{
+		Stalled_trace trace;
+		trace.record(Register_op::SET_BITS, nullptr, uint32_t(0), uint32_t(1));
+		trace.stall_slot(1);
+		trace.record(Register_op::SET_BITS, nullptr, uint32_t(1), uint32_t(2));
+		trace.record(Register_op::SET_BITS, nullptr, uint32_t(2), uint32_t(3));
+
+		EXPECT_EQ(trace.total(), 3);
+		EXPECT_EQ(trace.dropped(), 1);
+
+		std::array<Register_trace_record, 4> recs;
+		ASSERT_EQ(trace.snapshot(recs.data(), recs.size()), 2);
+		EXPECT_EQ(recs[0].seq, 0);
+		EXPECT_EQ(recs[1].seq, 2);
+	}
+
+	TEST(Register_trace, concurrent_record)
+	{
+		typedef Register_trace_buffer<64> Big_buffer;
+		static Big_buffer trace;
+
+		std::vector<std::thread> threads;
+		for(size_t t = 0; t < 4; t++)
+		{
+			threads.emplace_back([t]()
+			{
+				for(uint32_t i = 0; i < 10000; i++)
+				{
+					trace.record(Register_op::SET_BITS, nullptr, uint32_t(t), i);
+				}
+			});
+		}
+
+		std::array<Register_trace_record, 64> recs;
+		for(size_t i = 0; i < 100; i++)
+		{
+			const size_t num = trace.snapshot(recs.data(), recs.size());
+			for(size_t j = 1; j < num; j++)
+			{
+				ASSERT_LT(recs[j-1].seq, recs[j].seq);
+			}
+			for(size_t j = 0; j < num; j++)
+			{
+				ASSERT_LT(recs[j].old_val, 4);
+				ASSERT_LT(recs[j].new_val, 10000);
+			}
+		}
+
+		for(std::thread& th : threads)
+		{
+			th.join();
+		}
+
+		EXPECT_EQ(trace.total(), 40000);
+
+		//a writer preempted mid record can cost a record, otherwise the ring is full
+		const size_t num = trace.snapshot(recs.data(), recs.size());
+		EXPECT_LE(num, 64);
+		EXPECT_GE(num + trace.dropped(), 64);
+		for(size_t j = 0; j < num; j++)
+		{
+			EXPECT_GE(recs[j].seq, 40000 - 64);
+		}
+	}
+}
@@ -0,0 +1,150 @@
+#include "common_util/Register_txn.hpp"
+#include "common_util/Sim_register.hpp"
+
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+
+#include <utility>
+#include <vector>
+
+namespace
+{
+	//records the order of writes
+	struct Logged_register
+	{
+		uint32_t value;
+		std::vector< std::pair<const Logged_register*, uint32_t> >* log;
+	};
+}
+
+template<>
+struct Register_traits<Logged_register>
+{
+	typedef uint32_t value_type;
+
+	static inline value_type read(Logged_register* const reg)
+	{
+		return reg->value;
+	}
+
+	static inline void write(Logged_register* const reg, const value_type val)
+	{
+		reg->value = val;
+		reg->log->push_back(std::make_pair(reg, val));
+	}
+};
+
+namespace
+{
+	TEST(Register_txn, coalesce)
+	{
+		Sim_register_bank<uint32_t, 3> bank;
+		bank[0].poke(0xFF00);
+		bank[1].poke(0xFF00);
+
+		Register_txn<uint32_t, 4, Sim_register<uint32_t>> txn;
+		EXPECT_TRUE(txn.mask_set_bits(bank.get_reg(0), 0x0F, 0x05));
+		EXPECT_TRUE(txn.set_bits(bank.get_reg(1), 0x1));
+		EXPECT_TRUE(txn.clear_bits(bank.get_reg(0), 0x0100));
+		EXPECT_TRUE(txn.set_bits(bank.get_reg(0), 0x10));
+		EXPECT_TRUE(txn.write(bank.get_reg(2), 0x1234));
+		EXPECT_TRUE(txn.set_bits(bank.get_reg(2), 0x8000));
+		EXPECT_EQ(txn.size(), 3);
+		EXPECT_EQ(bank.total_writes(), 0);
+
+		txn.commit();
+		EXPECT_TRUE(txn.empty());
+
+		EXPECT_EQ(bank[0].peek(), 0xFE15);
+		EXPECT_EQ(bank[1].peek(), 0xFF01);
+		EXPECT_EQ(bank[2].peek(), 0x9234);
+
+		//register 2 was fully overwritten, so it was never read
+		EXPECT_EQ(bank.total_reads(), 2);
+		EXPECT_EQ(bank.total_writes(), 3);
+		EXPECT_EQ(bank[2].reads(), 0);
+	}
+
+	TEST(Register_txn, matches_register_util)
+	{
+		Sim_register_bank<uint32_t, 4> txn_bank;
+		Sim_register_bank<uint32_t, 4> ref_bank;
+
+		Register_txn<uint32_t, 4, Sim_register<uint32_t>> txn;
+
+		uint32_t seed = 1;
+		for(size_t i = 0; i < 64; i++)
+		{
+			seed = seed * 1103515245U + 12345U;
+			const size_t idx = (seed >> 16) % 4;
+			seed = seed * 1103515245U + 12345U;
+			const uint32_t mask = seed;
+			seed = seed * 1103515245U + 12345U;
+			const uint32_t x = seed & mask;
+
+			ASSERT_TRUE(txn.mask_set_bits(txn_bank.get_reg(idx), mask, x));
+			Register_util::mask_set_bits(ref_bank.get_reg(idx), mask, x);
+		}
+
+		txn.commit();
+
+		for(size_t i = 0; i < 4; i++)
+		{
+			EXPECT_EQ(txn_bank[i].peek(), ref_bank[i].peek());
+		}
+		EXPECT_LE(txn_bank.total_writes(), 4);
+		EXPECT_EQ(ref_bank.total_writes(), 64);
+	}
+
+	TEST(Register_txn, barrier_order)
+	{
+		std::vector< std::pair<const Logged_register*, uint32_t> > log;
+		std::array<Logged_register, 3> regs = {{{0, &log}, {0, &log}, {0, &log}}};
+
+		Register_txn<uint32_t, 8, Logged_register> txn;
+		txn.set_bits(&regs[2], 0x1);
+		txn.set_bits(&regs[0], 0x1);
+		txn.barrier();
+		txn.set_bits(&regs[2], 0x2);
+		txn.set_bits(&regs[1], 0x1);
+		txn.commit();
+
+		//sorted within each segment, never merged or reordered across the barrier
+		ASSERT_EQ(log.size(), 4);
+		EXPECT_EQ(log[0], std::make_pair<const Logged_register*>(&regs[0], uint32_t(0x1)));
+		EXPECT_EQ(log[1], std::make_pair<const Logged_register*>(&regs[2], uint32_t(0x1)));
+		EXPECT_EQ(log[2], std::make_pair<const Logged_register*>(&regs[1], uint32_t(0x1)));
+		EXPECT_EQ(log[3], std::make_pair<const Logged_register*>(&regs[2], uint32_t(0x3)));
+	}
+
+	TEST(Register_txn, full)
+	{
+		Sim_register_bank<uint32_t, 3> bank;
+
+		Register_txn<uint32_t, 2, Sim_register<uint32_t>> txn;
+		EXPECT_TRUE(txn.write(bank.get_reg(0), 1));
+		EXPECT_TRUE(txn.write(bank.get_reg(1), 2));
+		EXPECT_FALSE(txn.write(bank.get_reg(2), 3));
+
+		//merging into an existing entry still works
+		EXPECT_TRUE(txn.write(bank.get_reg(1), 4));
+
+		txn.commit();
+		EXPECT_EQ(bank[1].peek(), 4);
+		EXPECT_EQ(bank[2].writes(), 0);
+	}
+
+	TEST(Register_txn, volatile_register)
+	{
+		volatile uint32_t a = 0xF0;
+		volatile uint32_t b = 0;
+
+		Register_txn<uint32_t, 2> txn;
+		txn.clear_bits(&a, 0x10);
+		txn.write(&b, 7);
+		txn.commit();
+
+		EXPECT_EQ(a, 0xE0);
+		EXPECT_EQ(b, 7);
+	}
+}
@@ -0,0 +1,139 @@
+#include "common_util/Register_util.hpp"
+
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+namespace
+{
+	//stands in for the peripheral, sets bits in the register after a number of pauses
+	class Set_after_backoff
+	{
+	public:
+		Set_after_backoff(volatile uint32_t* const reg, const uint32_t bits, const uint32_t pauses) : m_reg(reg), m_bits(bits), m_pauses(pauses), m_count(0)
+		{
+
+		}
+
+		void pause()
+		{
+			m_count++;
+			if(m_count == m_pauses)
+			{
+				*m_reg = (*m_reg) ^ m_bits;
+			}
+		}
+
+		uint32_t count() const
+		{
+			return m_count;
+		}
+
+	protected:
+		volatile uint32_t* m_reg;
+		uint32_t m_bits;
+		uint32_t m_pauses;
+		uint32_t m_count;
+	};
+
+	TEST(Register_util, wait_until_set_budget)
+	{
+		volatile uint32_t reg = 0;
+
+		Spin_histogram<8> hist;
+		EXPECT_TRUE(Register_util::wait_until_set<uint32_t>(&reg, 0x4, Spin_budget(10), Set_after_backoff(&reg, 0x4, 5), &hist));
+		EXPECT_EQ(hist.count(), 1);
+		EXPECT_EQ(hist.max_polls(), 5);
+		EXPECT_EQ(hist.bucket(3), 1);
+		EXPECT_EQ(hist.timeouts(), 0);
+
+		//already set, no failed polls
+		EXPECT_TRUE(Register_util::wait_until_set<uint32_t>(&reg, 0x4, Spin_budget(0), No_backoff(), &hist));
+		EXPECT_EQ(hist.bucket(0), 1);
+	}
+
+	TEST(Register_util, wait_until_clear_budget)
+	{
+		volatile uint32_t reg = 0xFF;
+
+		//bit never clears within the budget
+		Spin_histogram<8> hist;
+		EXPECT_FALSE(Register_util::wait_until_clear<uint32_t>(&reg, 0x80, Spin_budget(4), Set_after_backoff(&reg, 0x80, 5), &hist));
+		EXPECT_EQ(hist.timeouts(), 1);
+		EXPECT_EQ(hist.max_polls(), 4);
+
+		EXPECT_TRUE(Register_util::wait_until_clear<uint32_t>(&reg, 0x80, Spin_budget(4), Set_after_backoff(&reg, 0x80, 2)));
+		EXPECT_EQ(reg, 0x7F);
+	}
+
+	TEST(Register_util, wait_until_value)
+	{
+		volatile uint32_t reg = 0x10;
+
+		EXPECT_TRUE(Register_util::wait_until_value<uint32_t>(&reg, 0x30, 0x30, No_timeout(), Set_after_backoff(&reg, 0x20, 100)));
+		EXPECT_FALSE(Register_util::wait_until_value<uint32_t>(&reg, 0x30, 0x20, Spin_budget(50), Exp_backoff<8>()));
+	}
+
+	TEST(Register_util, wait_until_deadline)
+	{
+		volatile uint32_t reg = 0;
+
+		typedef Deadline<std::chrono::steady_clock> Steady_deadline;
+
+		const auto start = std::chrono::steady_clock::now();
+		EXPECT_FALSE(Register_util::wait_until_set<uint32_t>(&reg, 0x1, Steady_deadline::from_now(std::chrono::milliseconds(2)), Cpu_relax_backoff()));
+		EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(2));
+
+		//deadline already passed still polls once
+		reg = 1;
+		EXPECT_TRUE(Register_util::wait_until_set<uint32_t>(&reg, 0x1, Steady_deadline(start)));
+	}
+
+	//reg is not declared volatile, without the volatile access in Register_traits an optimized build drops the wait entirely
+	TEST(Register_util, wait_until_set_plain_pointer)
+	{
+		uint32_t reg = 0;
+		std::atomic<bool> writing(false);
+
+		std::thread device([&reg, &writing]()
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(5));
+			writing = true;
+			*static_cast<volatile uint32_t*>(&reg) = 0x2;
+		});
+
+		Register_util::wait_until_set<uint32_t>(&reg, 0x2);
+		EXPECT_TRUE(writing);
+		device.join();
+
+		Register_util::set_bits<uint32_t>(&reg, 0x1);
+		Register_util::clear_bits<uint32_t>(&reg, 0x2);
+		EXPECT_EQ(reg, 0x1);
+	}
+
+	TEST(Register_util, spin_histogram_buckets)
+	{
+		typedef Spin_histogram<4> Hist;
+
+		EXPECT_EQ(Hist::bucket_index(0), 0);
+		EXPECT_EQ(Hist::bucket_index(1), 1);
+		EXPECT_EQ(Hist::bucket_index(2), 2);
+		EXPECT_EQ(Hist::bucket_index(3), 2);
+		EXPECT_EQ(Hist::bucket_index(4), 3);
+		EXPECT_EQ(Hist::bucket_index(0xFFFFFFFF), 3);
+
+		Hist hist;
+		hist.record(7, true);
+		hist.record(1000, false);
+		EXPECT_EQ(hist.bucket(3), 2);
+		EXPECT_EQ(hist.count(), 2);
+		EXPECT_EQ(hist.timeouts(), 1);
+		EXPECT_EQ(hist.max_polls(), 1000);
+
+		hist.clear();
+		EXPECT_EQ(hist.count(), 0);
+	}
+}
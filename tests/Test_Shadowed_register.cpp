@@ -0,0 +1,119 @@
+#include "common_util/Shadowed_register.hpp"
+#include "common_util/Sim_register.hpp"
+#include "common_util/Register_field.hpp"
+
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+
+namespace
+{
+	typedef Shadowed_register<uint32_t, Sim_register<uint32_t>> Shadowed_sim;
+
+	TEST(Shadowed_register, rmw_skips_read)
+	{
+		Sim_register<uint32_t> hw;
+		hw.poke(0x1000);
+
+		Shadowed_sim reg(&hw);
+
+		//first access loads the shadow
+		Register_util::set_bits<uint32_t>(&reg, 0x1);
+		Register_util::set_bits<uint32_t>(&reg, 0x2);
+		Register_util::clear_bits<uint32_t>(&reg, 0x1000);
+		Register_util::mask_set_bits<uint32_t>(&reg, 0xF0, 0x50);
+
+		EXPECT_EQ(hw.peek(), 0x53);
+		EXPECT_EQ(reg.shadow(), 0x53);
+		EXPECT_EQ(hw.reads(), 1);
+		EXPECT_EQ(hw.writes(), 4);
+	}
+
+	TEST(Shadowed_register, initial_value)
+	{
+		Sim_register<uint32_t> hw;
+
+		Shadowed_sim reg(&hw, 0x80);
+		EXPECT_TRUE(reg.valid());
+
+		Register_util::set_bits<uint32_t>(&reg, 0x1);
+		EXPECT_EQ(hw.peek(), 0x81);
+		EXPECT_EQ(hw.reads(), 0);
+		EXPECT_EQ(hw.writes(), 1);
+	}
+
+	TEST(Shadowed_register, sync_invalidate)
+	{
+		Sim_register<uint32_t> hw;
+		Shadowed_sim reg(&hw, 0);
+
+		//hardware changed behind the shadow
+		hw.poke(0x40);
+		EXPECT_EQ(reg.read(), 0);
+
+		reg.invalidate();
+		EXPECT_FALSE(reg.valid());
+		EXPECT_EQ(hw.reads(), 0);
+		EXPECT_EQ(reg.read(), 0x40);
+		EXPECT_EQ(hw.reads(), 1);
+
+		hw.poke(0x41);
+		reg.sync();
+		EXPECT_EQ(reg.shadow(), 0x41);
+		EXPECT_EQ(hw.reads(), 2);
+
+		//peripheral reset, restore from the shadow
+		hw.poke(0);
+		reg.write_back();
+		EXPECT_EQ(hw.peek(), 0x41);
+	}
+
+	TEST(Shadowed_register, wait_polls_hardware)
+	{
+		Sim_register<uint32_t> hw;
+		Shadowed_sim reg(&hw, 0);
+
+		//a wait on the shadow alone would never see this
+		hw.set_bits_after_reads(3, 0x4);
+		EXPECT_TRUE(Register_util::wait_until_set<uint32_t>(&reg, 0x4, Spin_budget(10)));
+		EXPECT_EQ(hw.reads(), 4);
+		EXPECT_EQ(reg.shadow(), 0x4);
+
+		hw.clear_bits_after_reads(1, 0x4);
+		Register_util::wait_until_clear<uint32_t>(&reg, 0x4);
+		EXPECT_EQ(reg.shadow(), 0);
+
+		//the shadow is current again, a read-modify-write does not read
+		hw.reset_counts();
+		Register_util::set_bits<uint32_t>(&reg, 0x1);
+		EXPECT_EQ(hw.reads(), 0);
+		EXPECT_EQ(hw.peek(), 0x1);
+	}
+
+	TEST(Shadowed_register, config_burst)
+	{
+		typedef Reg_field<0, 1> EN;
+		typedef Reg_field<1, 2> MODE;
+		typedef Reg_field<4, 4> DIV;
+
+		Sim_register_bank<uint32_t, 2> bank;
+
+		//same sequence of field updates to a plain and a shadowed register
+		Reg_base<Sim_register<uint32_t>, EN, MODE, DIV> plain(bank.get_reg(0));
+
+		Shadowed_sim shadow_reg(bank.get_reg(1), 0);
+		Reg_base<Shadowed_sim, EN, MODE, DIV> shadowed(&shadow_reg);
+
+		for(uint32_t i = 0; i < 8; i++)
+		{
+			plain.write<MODE, DIV>(i & 0x3, i);
+			plain.write<EN>(i & 0x1);
+
+			shadowed.write<MODE, DIV>(i & 0x3, i);
+			shadowed.write<EN>(i & 0x1);
+		}
+
+		EXPECT_EQ(bank[0].peek(), bank[1].peek());
+		EXPECT_EQ(bank[0].reads() + bank[0].writes(), 32);
+		EXPECT_EQ(bank[1].reads() + bank[1].writes(), 16);
+	}
+}
@@ -0,0 +1,93 @@
+#include "common_util/Sim_register.hpp"
+#include "common_util/Register_field.hpp"
+
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+
+namespace
+{
+	TEST(Sim_register, counts)
+	{
+		Sim_register<uint32_t> reg;
+		reg.poke(0xF0);
+
+		Register_util::set_bits<uint32_t>(&reg, 0x01);
+		Register_util::clear_bits<uint32_t>(&reg, 0x10);
+		Register_util::mask_set_bits<uint32_t>(&reg, 0x0F, 0x05);
+
+		EXPECT_EQ(reg.peek(), 0xE5);
+		EXPECT_EQ(reg.reads(), 3);
+		EXPECT_EQ(reg.writes(), 3);
+
+		reg.reset_counts();
+		EXPECT_EQ(reg.reads(), 0);
+		EXPECT_EQ(reg.writes(), 0);
+	}
+
+	TEST(Sim_register, set_after_reads)
+	{
+		Sim_register<uint32_t> reg;
+
+		//ready bit comes up on the 4th read
+		reg.set_bits_after_reads(3, 0x80);
+		Register_util::wait_until_set<uint32_t>(&reg, 0x80);
+		EXPECT_EQ(reg.reads(), 4);
+		EXPECT_FALSE(reg.effect_pending());
+
+		reg.reset_counts();
+		reg.clear_bits_after_reads(10, 0x80);
+
+		Spin_histogram<8> hist;
+		EXPECT_FALSE(Register_util::wait_until_clear<uint32_t>(&reg, 0x80, Spin_budget(5), No_backoff(), &hist));
+		EXPECT_EQ(reg.reads(), 5);
+		EXPECT_TRUE(Register_util::wait_until_clear<uint32_t>(&reg, 0x80, Spin_budget(10), No_backoff(), &hist));
+		EXPECT_EQ(reg.reads(), 11);
+		EXPECT_EQ(hist.timeouts(), 1);
+	}
+
+	TEST(Sim_register, w1c)
+	{
+		Sim_register<uint8_t> reg;
+		reg.set_w1c_mask(0xF0);
+		reg.poke(0xA5);
+
+		//writing 1 clears a w1c bit, writing 0 leaves it
+		reg.write(0x2F);
+		EXPECT_EQ(reg.peek(), 0x8F);
+
+		//a read-modify-write on a w1c register clears every pending flag
+		Register_util::set_bits<uint8_t>(&reg, 0x00);
+		EXPECT_EQ(reg.peek(), 0x0F);
+	}
+
+	typedef Reg_field<0, 1> EN;
+	typedef Reg_field<1, 2> MODE;
+	typedef Reg_field<4, 4> DIV;
+
+	TEST(Sim_register, reg_coalesces_writes)
+	{
+		Sim_register_bank<uint32_t, 4> bank;
+		Reg_base<Sim_register<uint32_t>, EN, MODE, DIV> ctrl(bank.get_reg(2));
+
+		ctrl.write<EN, MODE, DIV>(1, 3, 7);
+		EXPECT_EQ(bank[2].peek(), 0x77);
+		EXPECT_EQ(bank.total_reads(), 1);
+		EXPECT_EQ(bank.total_writes(), 1);
+
+		//the same update one field at a time
+		bank.reset_counts();
+		ctrl.write<EN>(0);
+		ctrl.write<MODE>(1);
+		ctrl.write<DIV>(2);
+		EXPECT_EQ(bank[2].peek(), 0x22);
+		EXPECT_EQ(bank.total_reads(), 3);
+		EXPECT_EQ(bank.total_writes(), 3);
+
+		bank.reset_counts();
+		ctrl.overwrite<DIV>(9);
+		EXPECT_EQ(ctrl.read<DIV>(), 9);
+		EXPECT_EQ(bank.total_reads(), 1);
+		EXPECT_EQ(bank.total_writes(), 1);
+		EXPECT_EQ(bank[0].reads(), 0);
+	}
+}
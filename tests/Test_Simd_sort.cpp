@@ -0,0 +1,114 @@
+#include "common_util/Simd_sort.hpp"
+
+#include "Test_util.hpp"
+
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+namespace
+{
+	template<typename T>
+	void check_sort(std::vector<T> v)
+	{
+		std::vector<T> ref = v;
+		std::sort(ref.begin(), ref.end());
+
+		simd_sort(v.data(), v.size());
+		ASSERT_EQ(v, ref) << "n " << v.size();
+	}
+
+	TEST(Simd_sort, sizes)
+	{
+		simd_sort(static_cast<int32_t*>(nullptr), 0);
+
+		for(size_t n = 1; n < 200; n++)
+		{
+			check_sort(make_random(n, 0, uint32_t(n)));
+			check_sort(make_random(n, 3, uint32_t(n)));
+		}
+	}
+
+	TEST(Simd_sort, patterns)
+	{
+		const size_t n = 100003;
+
+		std::vector<uint32_t> sorted(n);
+		for(size_t i = 0; i < n; i++)
+		{
+			sorted[i] = uint32_t(i);
+		}
+
+		std::vector<uint32_t> reversed(sorted.rbegin(), sorted.rend());
+
+		std::vector<uint32_t> saw(n);
+		for(size_t i = 0; i < n; i++)
+		{
+			saw[i] = uint32_t(i % 1000);
+		}
+
+		check_sort(sorted);
+		check_sort(reversed);
+		check_sort(saw);
+		check_sort(std::vector<uint32_t>(n, 42));
+		check_sort(make_random(n, 0, 1));
+		check_sort(make_random(n, 16, 2));
+
+		//u32 keys above INT32_MAX
+		std::vector<uint32_t> extremes = make_random(1000, 0, 3);
+		extremes.push_back(0);
+		extremes.push_back(0xFFFFFFFF);
+		extremes.push_back(0x80000000);
+		extremes.push_back(0x7FFFFFFF);
+		check_sort(extremes);
+	}
+
+	TEST(Simd_sort, int32)
+	{
+		std::vector<int32_t> v;
+		for(const uint32_t x : make_random(5000, 0, 4))
+		{
+			v.push_back(int32_t(x));
+		}
+		v.push_back(std::numeric_limits<int32_t>::min());
+		v.push_back(std::numeric_limits<int32_t>::max());
+		v.push_back(std::numeric_limits<int32_t>::max());
+
+		check_sort(v);
+	}
+
+	TEST(Simd_sort, float)
+	{
+		std::vector<float> v;
+		for(const uint32_t x : make_random(5000, 2000, 5))
+		{
+			v.push_back((float(x) - 1000.0f) / 7.0f);
+		}
+		v.push_back(std::numeric_limits<float>::infinity());
+		v.push_back(-std::numeric_limits<float>::infinity());
+		v.push_back(std::numeric_limits<float>::denorm_min());
+		v.push_back(-std::numeric_limits<float>::max());
+
+		check_sort(v);
+
+		std::vector<float> zeros = {0.0f, -0.0f, 1.0f, -0.0f, -1.0f, 0.0f};
+		simd_sort(zeros.data(), zeros.size());
+		EXPECT_TRUE(std::signbit(zeros[1]));
+		EXPECT_TRUE(std::signbit(zeros[2]));
+		EXPECT_FALSE(std::signbit(zeros[3]));
+		EXPECT_EQ(zeros.front(), -1.0f);
+		EXPECT_EQ(zeros.back(), 1.0f);
+
+		std::vector<float> nans = {2.0f, std::nanf(""), -std::nanf(""), 1.0f};
+		simd_sort(nans.data(), nans.size());
+		EXPECT_TRUE(std::isnan(nans[0]));
+		EXPECT_EQ(nans[1], 1.0f);
+		EXPECT_EQ(nans[2], 2.0f);
+		EXPECT_TRUE(std::isnan(nans[3]));
+	}
+}
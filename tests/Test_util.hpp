@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+///
+/// n pseudo random values from an LCG, the same seed always gives the same values
+/// mod 0 keeps the full 32 bits, otherwise values are in [0, mod)
+///
+inline std::vector<uint32_t> make_random(const size_t n, const uint32_t mod, uint32_t seed)
+{
+	std::vector<uint32_t> v(n);
+	for(size_t i = 0; i < n; i++)
+	{
+		seed = seed * 1103515245U + 12345U;
+		const uint32_t hi = seed >> 16;
+		seed = seed * 1103515245U + 12345U;
+		const uint32_t r = (hi << 16) | (seed >> 16);
+		v[i] = (mod == 0) ? r : (r % mod);
+	}
+	return v;
+}